@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <functional>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <libwire/address.hpp>
+
+using namespace libwire;
+
+// Mix of short and long textual forms so results are not dominated
+// by one code path.
+static const std::array<std::string, 8> ipv4_texts = {
+    "127.0.0.1", "0.0.0.0", "192.168.1.254", "10.0.0.1", "8.8.8.8", "172.16.254.1", "255.255.255.255", "1.2.3.4",
+};
+
+static const std::array<std::string, 8> ipv6_texts = {
+    "::1", "::", "2001:db8::ff00:42:8329", "fe80::1ff:fe23:4567:890a", "2001:0db8:0000:0000:0000:ff00:0042:8329",
+    "ff02::1", "::ffff:c000:280", "2a00:1450:4001:81c::200e",
+};
+
+template<size_t N>
+static std::array<address, N> parse_all(const std::array<std::string, N>& texts) {
+    std::array<address, N> result;
+    for (size_t i = 0; i < N; ++i) {
+        result[i] = address(texts[i]);
+    }
+    return result;
+}
+
+static void address_parse_ipv4(benchmark::State& state) {
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(address(ipv4_texts[i++ % ipv4_texts.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_parse_ipv4);
+
+static void address_parse_ipv6(benchmark::State& state) {
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(address(ipv6_texts[i++ % ipv6_texts.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_parse_ipv6);
+
+static void address_parse_view_ipv4(benchmark::State& state) {
+    std::error_code ec;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(address::parse(ipv4_texts[i++ % ipv4_texts.size()], ec));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_parse_view_ipv4);
+
+static void address_parse_view_ipv6(benchmark::State& state) {
+    std::error_code ec;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(address::parse(ipv6_texts[i++ % ipv6_texts.size()], ec));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_parse_view_ipv6);
+
+static void address_to_string_ipv4(benchmark::State& state) {
+    auto addresses = parse_all(ipv4_texts);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(addresses[i++ % addresses.size()].to_string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_to_string_ipv4);
+
+static void address_to_string_ipv6(benchmark::State& state) {
+    auto addresses = parse_all(ipv6_texts);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(addresses[i++ % addresses.size()].to_string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_to_string_ipv6);
+
+static void address_to_chars_ipv4(benchmark::State& state) {
+    auto addresses = parse_all(ipv4_texts);
+    std::array<char, address::max_text_length> buffer;
+    size_t i = 0;
+    for (auto _ : state) {
+        auto result = addresses[i++ % addresses.size()].to_chars(buffer.data(), buffer.data() + buffer.size());
+        benchmark::DoNotOptimize(result.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_to_chars_ipv4);
+
+static void address_to_chars_ipv6(benchmark::State& state) {
+    auto addresses = parse_all(ipv6_texts);
+    std::array<char, address::max_text_length> buffer;
+    size_t i = 0;
+    for (auto _ : state) {
+        auto result = addresses[i++ % addresses.size()].to_chars(buffer.data(), buffer.data() + buffer.size());
+        benchmark::DoNotOptimize(result.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_to_chars_ipv6);
+
+static void address_hash_ipv4(benchmark::State& state) {
+    auto addresses = parse_all(ipv4_texts);
+    std::hash<address> hasher;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hasher(addresses[i++ % addresses.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_hash_ipv4);
+
+static void address_hash_ipv6(benchmark::State& state) {
+    auto addresses = parse_all(ipv6_texts);
+    std::hash<address> hasher;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hasher(addresses[i++ % addresses.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(address_hash_ipv6);
@@ -0,0 +1,143 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <libwire/endpoint.hpp>
+#include <libwire/native_endpoint.hpp>
+#include <libwire/internal/system_utils.hpp>
+
+using namespace libwire;
+
+static const std::array<std::string_view, 8> endpoint_texts = {
+    "127.0.0.1:80",
+    "0.0.0.0:1",
+    "192.168.1.254:8080",
+    "10.0.0.1:65534",
+    "[::1]:443",
+    "[::]:22",
+    "[2001:db8::ff00:42:8329]:53",
+    "[fe80::1ff:fe23:4567:890a]:5353",
+};
+
+static std::array<endpoint, endpoint_texts.size()> parse_all() {
+    std::array<endpoint, endpoint_texts.size()> result{endpoint::invalid, endpoint::invalid, endpoint::invalid,
+                                                       endpoint::invalid, endpoint::invalid, endpoint::invalid,
+                                                       endpoint::invalid, endpoint::invalid};
+    for (size_t i = 0; i < endpoint_texts.size(); ++i) {
+        result[i] = endpoint(endpoint_texts[i]);
+    }
+    return result;
+}
+
+static void endpoint_parse(benchmark::State& state) {
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(endpoint(endpoint_texts[i++ % endpoint_texts.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(endpoint_parse);
+
+static void endpoint_parse_view(benchmark::State& state) {
+    std::error_code ec;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(endpoint::parse(endpoint_texts[i++ % endpoint_texts.size()], ec));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(endpoint_parse_view);
+
+static void endpoint_to_string(benchmark::State& state) {
+    auto endpoints = parse_all();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(endpoints[i++ % endpoints.size()].to_string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(endpoint_to_string);
+
+static void endpoint_to_chars(benchmark::State& state) {
+    auto endpoints = parse_all();
+    std::array<char, endpoint::max_text_length> buffer;
+    size_t i = 0;
+    for (auto _ : state) {
+        auto result = endpoints[i++ % endpoints.size()].to_chars(buffer.data(), buffer.data() + buffer.size());
+        benchmark::DoNotOptimize(result.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(endpoint_to_chars);
+
+static void endpoint_to_sockaddr(benchmark::State& state) {
+    auto endpoints = parse_all();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(internal_::endpoint_to_sockaddr(endpoints[i++ % endpoints.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(endpoint_to_sockaddr);
+
+static void sockaddr_to_endpoint(benchmark::State& state) {
+    std::array<sockaddr_storage, endpoint_texts.size()> addresses;
+    auto endpoints = parse_all();
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        addresses[i] = internal_::endpoint_to_sockaddr(endpoints[i]);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(internal_::sockaddr_to_endpoint(addresses[i++ % addresses.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(sockaddr_to_endpoint);
+
+static void native_endpoint_from_endpoint(benchmark::State& state) {
+    auto endpoints = parse_all();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_endpoint(endpoints[i++ % endpoints.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(native_endpoint_from_endpoint);
+
+static void native_endpoint_to_endpoint(benchmark::State& state) {
+    std::array<native_endpoint, endpoint_texts.size()> natives;
+    auto endpoints = parse_all();
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        natives[i] = native_endpoint(endpoints[i]);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(natives[i++ % natives.size()].to_endpoint());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(native_endpoint_to_endpoint);
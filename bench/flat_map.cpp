@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <libwire/flat_map.hpp>
+
+/*
+ * endpoint_map compared with std::unordered_map in scenario of UDP
+ * session tracker: lookup of known peer (hit), packet from unknown
+ * peer (miss) and session churn (insert + erase). Argument is count of
+ * sessions in table.
+ */
+
+using namespace libwire;
+
+namespace {
+    struct session {
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+    };
+
+    std::vector<endpoint> make_endpoints(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::vector<endpoint> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto value = random();
+            result.emplace_back(address(10, uint8_t(value >> 24u), uint8_t(value >> 16u), uint8_t(value >> 8u)),
+                                uint16_t(1024 + i % 60000));
+        }
+        return result;
+    }
+
+    template<typename Map>
+    void lookup_hit(benchmark::State& state) {
+        auto peers = make_endpoints(size_t(state.range(0)), 1);
+        Map map;
+        for (const auto& peer : peers) map[peer];
+
+        // Access order differs from insertion order like it does for real traffic.
+        std::shuffle(peers.begin(), peers.end(), std::mt19937(2));
+        size_t i = 0;
+        for (auto _ : state) {
+            auto it = map.find(peers[i++ % peers.size()]);
+            ++it->second.packets;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<typename Map>
+    void lookup_miss(benchmark::State& state) {
+        auto peers = make_endpoints(size_t(state.range(0)), 1);
+        auto strangers = make_endpoints(size_t(state.range(0)), 3);
+        Map map;
+        for (const auto& peer : peers) map[peer];
+
+        size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(map.find(strangers[i++ % strangers.size()]) == map.end());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<typename Map>
+    void churn(benchmark::State& state) {
+        auto peers = make_endpoints(size_t(state.range(0)) * 2, 1);
+        Map map;
+        size_t half = peers.size() / 2;
+        for (size_t i = 0; i < half; ++i) map[peers[i]];
+
+        // Sliding window: oldest session is closed, new one is opened.
+        size_t i = 0;
+        for (auto _ : state) {
+            map.erase(peers[i % peers.size()]);
+            map[peers[(i + half) % peers.size()]];
+            ++i;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+} // namespace
+
+using std_map = std::unordered_map<endpoint, session>;
+using flat = endpoint_map<session>;
+
+BENCHMARK_TEMPLATE(lookup_hit, std_map)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_hit, flat)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_miss, std_map)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(lookup_miss, flat)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(churn, std_map)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(churn, flat)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
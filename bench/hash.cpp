@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <libwire/endpoint.hpp>
+
+/*
+ * Compares speed and bucket distribution of std::hash for address and
+ * endpoint against byte-by-byte hash_combine previously used by libwire.
+ *
+ * Distribution counters are computed for power-of-two table with one
+ * bucket per key indexed by lowest hash bits (worst case for weak hashes):
+ *  - collisions - fraction of keys landing into already occupied bucket,
+ *    perfectly random hash gives ~0.37 for such table;
+ *  - max_bucket - length of longest chain.
+ */
+
+using namespace libwire;
+
+namespace {
+    struct legacy_address_hash {
+        size_t operator()(const address& addr) const noexcept {
+            std::hash<uint8_t> hash;
+            auto result = size_t(addr.version);
+            for (const uint8_t& i : addr.parts) {
+                result ^= hash(i) + 0x9e3779b9u + (result << 6u) + (result >> 2u);
+            }
+            return result;
+        }
+    };
+
+    struct legacy_endpoint_hash {
+        size_t operator()(const endpoint& ep) const noexcept {
+            return legacy_address_hash()(ep.addr) ^ std::hash<uint16_t>()(ep.port);
+        }
+    };
+
+    constexpr size_t keys_count = 1u << 16u;
+
+    // 10.0.0.0/16, typical for per-peer tables of internal services.
+    const std::vector<address>& ipv4_keys() {
+        static const std::vector<address> keys = [] {
+            std::vector<address> result;
+            for (size_t i = 0; i < keys_count; ++i) {
+                result.emplace_back(10, 0, uint8_t(i >> 8u), uint8_t(i));
+            }
+            return result;
+        }();
+        return keys;
+    }
+
+    // 2001:db8::/64 with sequential interface identifiers.
+    const std::vector<address>& ipv6_keys() {
+        static const std::vector<address> keys = [] {
+            std::vector<address> result;
+            for (size_t i = 0; i < keys_count; ++i) {
+                result.emplace_back(0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, uint8_t(i >> 8u), uint8_t(i));
+            }
+            return result;
+        }();
+        return keys;
+    }
+
+    // Many clients behind one NAT address, only port differs.
+    const std::vector<endpoint>& endpoint_keys() {
+        static const std::vector<endpoint> keys = [] {
+            std::vector<endpoint> result;
+            for (size_t i = 0; i < keys_count; ++i) {
+                result.emplace_back(address(203, 0, 113, 7), uint16_t(i));
+            }
+            return result;
+        }();
+        return keys;
+    }
+
+    template<typename Key, typename Hasher>
+    void hash_keys(benchmark::State& state, const std::vector<Key>& (*make_keys)(), Hasher hasher) {
+        const auto& keys = make_keys();
+
+        std::vector<size_t> buckets(keys.size());
+        size_t collisions = 0;
+        for (const auto& key : keys) {
+            if (buckets[hasher(key) & (buckets.size() - 1)]++ != 0) ++collisions;
+        }
+        state.counters["collisions"] = double(collisions) / double(keys.size());
+        state.counters["max_bucket"] = double(*std::max_element(buckets.begin(), buckets.end()));
+
+        size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(hasher(keys[i++ & (keys.size() - 1)]));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(hash_keys, address_ipv4_legacy, ipv4_keys, legacy_address_hash());
+BENCHMARK_CAPTURE(hash_keys, address_ipv4, ipv4_keys, std::hash<address>());
+BENCHMARK_CAPTURE(hash_keys, address_ipv6_legacy, ipv6_keys, legacy_address_hash());
+BENCHMARK_CAPTURE(hash_keys, address_ipv6, ipv6_keys, std::hash<address>());
+BENCHMARK_CAPTURE(hash_keys, endpoint_legacy, endpoint_keys, legacy_endpoint_hash());
+BENCHMARK_CAPTURE(hash_keys, endpoint, endpoint_keys, std::hash<endpoint>());
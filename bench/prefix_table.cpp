@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <libwire/prefix_table.hpp>
+
+/*
+ * Longest-prefix-match lookups in table shaped like full BGP view:
+ * IPv4 prefixes are mostly /24 with some shorter ones, IPv6 ones are
+ * /32-/48. Argument is count of prefixes.
+ */
+
+using namespace libwire;
+
+namespace {
+    std::vector<cidr> make_prefixes(ip version, size_t count) {
+        std::mt19937 random(1);
+        std::vector<cidr> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            address addr;
+            addr.version = version;
+            for (auto& part : addr.parts) part = uint8_t(random());
+            uint8_t length;
+            if (version == ip::v4) {
+                length = random() % 8 == 0 ? uint8_t(8 + random() % 16) : 24;
+            } else {
+                length = uint8_t(32 + random() % 17);
+            }
+            result.emplace_back(addr, length);
+        }
+        return result;
+    }
+
+    // Half of addresses are inside of some prefix, half are random.
+    std::vector<address> make_probes(const std::vector<cidr>& prefixes) {
+        std::mt19937 random(2);
+        std::vector<address> result;
+        for (size_t i = 0; i < 1u << 16u; ++i) {
+            address addr = prefixes[random() % prefixes.size()].addr;
+            size_t size = addr.version == ip::v4 ? 4 : 16;
+            size_t keep = i % 2 != 0 ? 0 : size / 4 + 2; // At least /24 or /48 of prefix.
+            for (size_t j = keep; j < size; ++j) addr.parts[j] = uint8_t(random());
+            result.push_back(addr);
+        }
+        return result;
+    }
+
+    void prefix_table_lookup(benchmark::State& state, ip version) {
+        auto prefixes = make_prefixes(version, size_t(state.range(0)));
+        prefix_table<uint32_t> table;
+        for (size_t i = 0; i < prefixes.size(); ++i) table.insert_or_assign(prefixes[i], uint32_t(i));
+        auto probes = make_probes(prefixes);
+
+        size_t i = 0, found = 0;
+        for (auto _ : state) {
+            const uint32_t* value = table.lookup(probes[i++ % probes.size()]);
+            found += value != nullptr;
+            benchmark::DoNotOptimize(value);
+        }
+        state.counters["hit_rate"] = double(found) / double(state.iterations());
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void prefix_table_insert(benchmark::State& state, ip version) {
+        auto prefixes = make_prefixes(version, size_t(state.range(0)));
+        for (auto _ : state) {
+            prefix_table<uint32_t> table;
+            for (size_t i = 0; i < prefixes.size(); ++i) table.insert_or_assign(prefixes[i], uint32_t(i));
+            benchmark::DoNotOptimize(table.size());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(prefix_table_lookup, ipv4, ip::v4)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_CAPTURE(prefix_table_lookup, ipv6, ip::v6)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 18);
+BENCHMARK_CAPTURE(prefix_table_insert, ipv4, ip::v4)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(prefix_table_insert, ipv6, ip::v6)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
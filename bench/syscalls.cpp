@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils.hpp"
+#include <atomic>
+
+#if defined(__linux__)
+#    include <dlfcn.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <sys/socket.h>
+#    include <sys/uio.h>
+#    include <sys/sendfile.h>
+#endif
+
+/*
+ * Benchmarks are linked statically with libwire, so definitions below
+ * take precedence over libc ones for all calls made by library. Each
+ * wrapper counts call and forwards it to next definition (libc).
+ */
+
+namespace {
+    std::atomic<uint64_t> counter{0};
+} // namespace
+
+uint64_t bench::io_syscalls() noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+#if defined(__linux__)
+#    define COUNTED(ret, name, params, args)                                             \
+        extern "C" ret name params {                                                     \
+            static auto next = reinterpret_cast<ret(*) params>(dlsym(RTLD_NEXT, #name)); \
+            counter.fetch_add(1, std::memory_order_relaxed);                             \
+            return next args;                                                            \
+        }
+
+COUNTED(ssize_t, read, (int fd, void* buf, size_t count), (fd, buf, count))
+COUNTED(ssize_t, write, (int fd, const void* buf, size_t count), (fd, buf, count))
+COUNTED(ssize_t, pread, (int fd, void* buf, size_t count, off_t offset), (fd, buf, count, offset))
+COUNTED(ssize_t, readv, (int fd, const iovec* iov, int count), (fd, iov, count))
+COUNTED(ssize_t, writev, (int fd, const iovec* iov, int count), (fd, iov, count))
+COUNTED(ssize_t, send, (int fd, const void* buf, size_t len, int flags), (fd, buf, len, flags))
+COUNTED(ssize_t, recv, (int fd, void* buf, size_t len, int flags), (fd, buf, len, flags))
+COUNTED(ssize_t, sendto,
+        (int fd, const void* buf, size_t len, int flags, const sockaddr* addr, socklen_t addr_len),
+        (fd, buf, len, flags, addr, addr_len))
+COUNTED(ssize_t, recvfrom, (int fd, void* buf, size_t len, int flags, sockaddr* addr, socklen_t* addr_len),
+        (fd, buf, len, flags, addr, addr_len))
+COUNTED(ssize_t, sendmsg, (int fd, const msghdr* message, int flags), (fd, message, flags))
+COUNTED(ssize_t, recvmsg, (int fd, msghdr* message, int flags), (fd, message, flags))
+COUNTED(int, sendmmsg, (int fd, mmsghdr* messages, unsigned int count, int flags), (fd, messages, count, flags))
+COUNTED(int, recvmmsg, (int fd, mmsghdr* messages, unsigned int count, int flags, timespec* timeout),
+        (fd, messages, count, flags, timeout))
+
+COUNTED(ssize_t, splice, (int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len, unsigned int flags),
+        (fd_in, off_in, fd_out, off_out, len, flags))
+COUNTED(ssize_t, sendfile, (int out_fd, int in_fd, off_t* offset, size_t count), (out_fd, in_fd, offset, count))
+
+#    undef COUNTED
+#endif
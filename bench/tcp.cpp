@@ -0,0 +1,344 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Loopback TCP ping-pong harness.
+ *
+ * Each benchmark thread opens `connections` connections to in-process echo
+ * server and sends `size`-byte messages round-robin over them, waiting for
+ * echo after each message. Reported counters:
+ * - bytes_per_second - payload sent by clients,
+ * - p50_us, p99_us, p999_us - round-trip latency (averaged over threads),
+ * - syscalls_per_msg - read/write system calls by client *and* server
+ *   per round-trip (Linux only, see syscalls.cpp).
+ *
+ * Modes cover blocking I/O paths of tcp::socket (read, read_until, write)
+ * and tcp::buffered_socket::read_until for comparison.
+ *
+ * tcp_send_file streams `size`-byte file to in-process sink using
+ * tcp::socket::send_file or pread + tcp::socket::write_all for comparison.
+ *
+ * tcp_forward relays endless stream from in-process writer to sink using
+ * tcp::forward with `buffer`-byte forward_buffer or, for comparison,
+ * read_some + write_all through `buffer`-byte user-space buffer.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <libwire/tcp.hpp>
+#include <libwire/options.hpp>
+#include "utils.hpp"
+
+#if defined(__linux__)
+#    include <unistd.h>
+#endif
+
+using namespace libwire;
+
+namespace {
+    enum class mode : uint8_t {
+        /// Fixed size messages, tcp::socket::read.
+        exact = 'r',
+
+        /// Newline-terminated messages, tcp::socket::read_until.
+        until = 'u',
+
+        /// Newline-terminated messages, tcp::buffered_socket::read_until.
+        buffered_until = 'b',
+
+        /// Arbitrary stream, discarded by server.
+        sink = 's',
+    };
+
+    struct header {
+        mode m;
+        uint32_t size;
+    };
+
+    /**
+     * Echo one connection until client disconnects.
+     */
+    void serve(tcp::socket sock) {
+        std::error_code ec;
+        auto raw_header = sock.read(1 + sizeof(uint32_t), ec);
+        if (ec) return;
+        header h{mode(raw_header[0]), 0};
+        std::memcpy(&h.size, raw_header.data() + 1, sizeof(h.size));
+
+        std::vector<uint8_t> buffer;
+        buffer.reserve(h.size + 1);
+        switch (h.m) {
+        case mode::exact:
+            while (sock.read(h.size, buffer, ec), !ec) {
+                sock.write(buffer, ec);
+                if (ec) return;
+            }
+            break;
+        case mode::until:
+            while (sock.read_until('\n', buffer, ec), !ec) {
+                buffer.push_back('\n');
+                sock.write(buffer, ec);
+                if (ec) return;
+            }
+            break;
+        case mode::sink:
+            buffer.resize(256 * 1024);
+            while (sock.read_some(buffer, ec), !ec) {
+            }
+            break;
+        case mode::buffered_until:
+            tcp::buffered_socket buffered(std::move(sock));
+            while (buffered.read_until('\n', buffer, ec), !ec) {
+                buffer.push_back('\n');
+                buffered.write(buffer, ec);
+                if (ec) return;
+            }
+            break;
+        }
+    }
+
+    /**
+     * Echo server running in background for whole process lifetime.
+     */
+    class echo_server {
+    public:
+        echo_server() {
+            listener.listen({ipv4::loopback, 0});
+            target = listener.local_endpoint();
+            std::thread([this]() {
+                std::error_code ec;
+                for (;;) {
+                    tcp::socket sock = listener.accept(ec);
+                    if (ec == error::connection_aborted || ec == error::interrupted) continue;
+                    if (ec == error::generic::no_resources) {
+                        // Retrying immediately would spin and skew measurements.
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        continue;
+                    }
+                    if (ec) {
+                        std::fprintf(stderr, "echo server: accept failed: %s\n", ec.message().c_str());
+                        return;
+                    }
+                    sock.set_option(tcp::no_delay, true);
+                    std::thread(serve, std::move(sock)).detach();
+                }
+            }).detach();
+        }
+
+        static echo_server& instance() {
+            // Intentionally leaked: accept thread runs until process exit.
+            static echo_server* server = new echo_server();
+            return *server;
+        }
+
+        endpoint target = endpoint::invalid;
+
+    private:
+        tcp::listener listener;
+    };
+
+    template<typename Socket>
+    void connect(Socket& sock, mode m, uint32_t size) {
+        sock.connect(echo_server::instance().target);
+        std::vector<uint8_t> raw_header(1 + sizeof(uint32_t));
+        raw_header[0] = uint8_t(m);
+        std::memcpy(raw_header.data() + 1, &size, sizeof(size));
+        sock.write(raw_header);
+    }
+
+    tcp::socket& plain(tcp::socket& sock) {
+        return sock;
+    }
+
+    tcp::socket& plain(tcp::buffered_socket& sock) {
+        return sock.next_layer();
+    }
+
+    template<mode Mode, typename Socket>
+    void tcp_ping_pong(benchmark::State& state) {
+        const auto size = uint32_t(state.range(0));
+        const auto connection_count = size_t(state.range(1));
+
+        std::vector<Socket> connections(connection_count);
+        for (Socket& sock : connections) {
+            connect(sock, Mode, size);
+            plain(sock).set_option(tcp::no_delay, true);
+        }
+
+        std::vector<uint8_t> message(size, 'x'), response;
+        response.reserve(size + 1);
+        if constexpr (Mode != mode::exact) message.back() = '\n';
+
+        std::vector<std::chrono::nanoseconds> latencies;
+        latencies.reserve(1u << 20u);
+
+        uint64_t syscalls_before = state.thread_index() == 0 ? bench::io_syscalls() : 0;
+        size_t next = 0;
+        for (auto _ : state) {
+            Socket& sock = connections[next++ % connections.size()];
+            auto start = std::chrono::steady_clock::now();
+            sock.write(message);
+            if constexpr (Mode == mode::exact) {
+                sock.read(size, response);
+            } else {
+                sock.read_until('\n', response);
+            }
+            latencies.push_back(std::chrono::steady_clock::now() - start);
+        }
+
+        state.SetBytesProcessed(int64_t(state.iterations()) * size);
+        state.counters["p50_us"] = {bench::to_us(bench::percentile(latencies, 0.5)), benchmark::Counter::kAvgThreads};
+        state.counters["p99_us"] = {bench::to_us(bench::percentile(latencies, 0.99)), benchmark::Counter::kAvgThreads};
+        state.counters["p999_us"] = {bench::to_us(bench::percentile(latencies, 0.999)),
+                                     benchmark::Counter::kAvgThreads};
+        if (state.thread_index() == 0) {
+            // Counters are summed over threads, so only one of them reports.
+            double messages = double(state.iterations()) * state.threads();
+            state.counters["syscalls_per_msg"] = double(bench::io_syscalls() - syscalls_before) / messages;
+        } else {
+            state.counters["syscalls_per_msg"] = 0;
+        }
+    }
+
+    void exact_sizes(benchmark::internal::Benchmark* b) {
+        b->ArgNames({"size", "connections"});
+        b->ArgsProduct({{64, 1024, 16 * 1024, 256 * 1024}, {1, 8}});
+        b->ThreadRange(1, 4);
+        b->UseRealTime();
+    }
+
+    void line_sizes(benchmark::internal::Benchmark* b) {
+        // tcp::socket::read_until reads byte-by-byte, larger messages
+        // take too long to be useful.
+        b->ArgNames({"size", "connections"});
+        b->ArgsProduct({{64, 1024, 4 * 1024}, {1, 8}});
+        b->ThreadRange(1, 4);
+        b->UseRealTime();
+    }
+
+#if defined(__linux__)
+    template<bool SendFile>
+    void tcp_send_file(benchmark::State& state) {
+        const auto size = size_t(state.range(0));
+
+        std::vector<uint8_t> contents(size, 'x');
+        FILE* file = std::tmpfile();
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fflush(file);
+        const int fd = fileno(file);
+
+        tcp::socket sock;
+        connect(sock, mode::sink, 0);
+
+        std::vector<uint8_t> buffer(size);
+        uint64_t syscalls_before = bench::io_syscalls();
+        for (auto _ : state) {
+            if constexpr (SendFile) {
+                sock.send_file(fd, 0, size);
+            } else {
+                ::pread(fd, buffer.data(), buffer.size(), 0);
+                sock.write_all(buffer);
+            }
+        }
+
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+        state.counters["syscalls_per_file"] = double(bench::io_syscalls() - syscalls_before) /
+                                              double(state.iterations());
+        std::fclose(file);
+    }
+
+    void file_sizes(benchmark::internal::Benchmark* b) {
+        b->ArgNames({"size"});
+        b->RangeMultiplier(16)->Range(64 * 1024, 16 * 1024 * 1024);
+        b->UseRealTime();
+    }
+#endif
+
+    template<bool Splice>
+    void tcp_forward(benchmark::State& state) {
+        const auto buffer_size = size_t(state.range(0));
+        const uint64_t chunk = 4 * 1024 * 1024;
+
+        tcp::listener listener({ipv4::loopback, 0});
+        tcp::socket writer_sock;
+        std::thread connect_thr([&]() { writer_sock.connect(listener.local_endpoint()); });
+        tcp::socket source = listener.accept();
+        connect_thr.join();
+        source.set_option(tcp::linger, true, std::chrono::seconds(0));
+
+        tcp::socket destination;
+        connect(destination, mode::sink, 0);
+
+        std::thread writer([&]() {
+            std::vector<uint8_t> data(256 * 1024, 'x');
+            std::error_code ec;
+            while (!ec) writer_sock.write(data, ec);
+        });
+
+        tcp::forward_buffer forward_buffer(buffer_size);
+        std::vector<uint8_t> buffer(buffer_size);
+        uint64_t syscalls_before = bench::io_syscalls();
+        for (auto _ : state) {
+            if constexpr (Splice) {
+                tcp::forward(source, destination, forward_buffer, chunk);
+            } else {
+                uint64_t moved = 0;
+                while (moved < chunk) {
+                    buffer.resize(buffer_size);
+                    buffer.resize(source.read_some(buffer));
+                    moved += destination.write_all(buffer);
+                }
+            }
+        }
+
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(chunk));
+        state.counters["syscalls_per_mb"] = double(bench::io_syscalls() - syscalls_before) /
+                                            double(state.iterations() * chunk / (1024 * 1024));
+
+        // Reset connection, so writer fails and stops.
+        source.close();
+        writer.join();
+    }
+
+    void forward_buffer_sizes(benchmark::internal::Benchmark* b) {
+        b->ArgNames({"buffer"});
+        b->RangeMultiplier(4)->Range(64 * 1024, 1024 * 1024);
+        b->UseRealTime();
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(tcp_ping_pong, mode::exact, tcp::socket)->Apply(exact_sizes);
+BENCHMARK_TEMPLATE(tcp_ping_pong, mode::until, tcp::socket)->Apply(line_sizes);
+BENCHMARK_TEMPLATE(tcp_ping_pong, mode::buffered_until, tcp::buffered_socket)->Apply(line_sizes);
+
+BENCHMARK_TEMPLATE(tcp_forward, false)->Apply(forward_buffer_sizes);
+BENCHMARK_TEMPLATE(tcp_forward, true)->Apply(forward_buffer_sizes);
+
+#if defined(__linux__)
+BENCHMARK_TEMPLATE(tcp_send_file, false)->Apply(file_sizes);
+BENCHMARK_TEMPLATE(tcp_send_file, true)->Apply(file_sizes);
+#endif
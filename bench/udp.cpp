@@ -0,0 +1,310 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Loopback UDP packets-per-second harness.
+ *
+ * Benchmark thread sends `size`-byte datagrams as fast as it can while
+ * background thread receives them. Receiver's buffer overflows when it
+ * can't keep up, that's reported as drop rate. Reported counters:
+ * - sent_pps, received_pps - datagrams per second,
+ * - drop_rate - fraction of sent datagrams that were never received,
+ * - cpu_ns_per_packet - process CPU time (sender + receiver) per
+ *   received datagram,
+ * - syscalls_per_packet - socket system calls per received datagram
+ *   (Linux only, see syscalls.cpp).
+ *
+ * Modes:
+ * - associated - udp::socket::associate + write, read without source,
+ * - unassociated - write with explicit destination (sendto), read with
+ *   source (recvfrom),
+ * - native - same as unassociated but with native_endpoint, so addresses
+ *   are not converted on each call,
+ * - batched - write_batch/read_batch with up to 32 datagrams per call.
+ * - segmented - write_segmented with 32 datagrams per call (UDP_SEGMENT
+ *   where supported), read_batch.
+ * - coalesced - same as segmented but read_coalesced with receive_offload
+ *   (UDP_GRO) enabled.
+ * - timestamped - same as associated but read with datagram_info and
+ *   receive_timestamp/receive_drop_count enabled, additionally reports
+ *   queue_delay_us (mean time between kernel receive and read returning)
+ *   and kernel_drops (drop counter reported by kernel).
+ *
+ * udp_group benchmark sends datagrams from 64 client sockets to
+ * udp::socket_group of `sockets` sockets, each read by its own thread,
+ * so received_pps shows how receiving scales with count of sockets (on
+ * machine with enough cores). Steered variant uses steer_by_cpu, on
+ * loopback datagrams are received on sender's CPU so all of them go to
+ * one socket, it's expected to scale only with multi-queue NIC.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <libwire/udp.hpp>
+#include "utils.hpp"
+
+using namespace libwire;
+using namespace std::literals::chrono_literals;
+
+namespace {
+    enum class mode {
+        associated,
+        unassociated,
+        native,
+        batched,
+        segmented,
+        coalesced,
+        timestamped,
+    };
+
+    constexpr size_t batch_size = 32;
+
+    /**
+     * Kernel receive information collected in timestamped mode.
+     */
+    struct receive_stats {
+        std::chrono::nanoseconds queue_delay{0};
+        uint32_t drops = 0;
+    };
+
+    /**
+     * Receive datagrams until datagram with size other than size
+     * arrives (end marker), return count of datagrams received.
+     */
+    uint64_t receive(udp::socket& sock, mode m, size_t size, std::atomic<bool>& done, receive_stats& stats) {
+        uint64_t received = 0;
+        std::error_code ec;
+        if (m == mode::batched || m == mode::segmented) {
+            std::vector<std::vector<uint8_t>> buffers(batch_size, std::vector<uint8_t>(size + 1));
+            std::vector<udp::datagram> datagrams;
+            for (auto& buffer : buffers) {
+                datagrams.emplace_back(memory_view(buffer.data(), buffer.size()));
+            }
+            for (;;) {
+                size_t count = sock.read_batch(datagrams, ec);
+                for (size_t i = 0; i < count; ++i) {
+                    if (datagrams[i].size != size) {
+                        done = true;
+                        return received;
+                    }
+                    ++received;
+                }
+            }
+        }
+
+        if (m == mode::coalesced) {
+            std::vector<uint8_t> buffer(64 * 1024);
+            for (;;) {
+                auto datagrams = sock.read_coalesced({buffer.data(), buffer.size()}, ec);
+                if (ec) continue;
+                for (memory_view datagram : datagrams) {
+                    if (datagram.size() != size) {
+                        done = true;
+                        return received;
+                    }
+                    ++received;
+                }
+            }
+        }
+
+        if (m == mode::timestamped) {
+            std::vector<uint8_t> buffer(size + 1);
+            for (;;) {
+                udp::datagram_info info = sock.read({buffer.data(), buffer.size()}, ec);
+                if (ec) continue;
+                stats.queue_delay += std::chrono::system_clock::now() - info.timestamp;
+                stats.drops = info.drops;
+                if (info.size != size) {
+                    done = true;
+                    return received;
+                }
+                ++received;
+            }
+        }
+
+        std::vector<uint8_t> buffer;
+        endpoint source = endpoint::invalid;
+        native_endpoint native_source;
+        for (;;) {
+            if (m == mode::unassociated) {
+                sock.read(size + 1, buffer, ec, &source);
+            } else if (m == mode::native) {
+                sock.read(size + 1, buffer, ec, native_source);
+            } else {
+                sock.read(size + 1, buffer, ec);
+            }
+            if (ec) continue;
+            if (buffer.size() != size) {
+                done = true;
+                return received;
+            }
+            ++received;
+        }
+    }
+
+    template<mode Mode>
+    void udp_blast(benchmark::State& state) {
+        const auto size = size_t(state.range(0));
+
+        udp::socket receiver(ip::v4), sender(ip::v4);
+        receiver.listen({ipv4::loopback, 0});
+        endpoint target = receiver.implementation().local_endpoint();
+        native_endpoint native_target(target);
+        if (Mode != mode::unassociated && Mode != mode::native) {
+            sender.associate(target);
+            receiver.associate(sender.implementation().local_endpoint());
+        }
+        if (Mode == mode::coalesced) {
+            receiver.set_option(udp::receive_offload, true);
+        }
+        if (Mode == mode::timestamped) {
+            receiver.set_option(udp::receive_timestamp, true);
+            receiver.set_option(udp::receive_drop_count, true);
+        }
+
+        std::atomic<bool> done{false};
+        uint64_t received = 0;
+        receive_stats stats;
+        std::thread receiver_thread([&]() { received = receive(receiver, Mode, size, done, stats); });
+
+        std::vector<uint8_t> message(size, 0xAB);
+        std::vector<udp::datagram> batch(batch_size, udp::datagram({message.data(), message.size()}));
+        std::vector<uint8_t> segments(size * batch_size, 0xAB);
+
+        uint64_t sent = 0;
+        uint64_t syscalls_before = bench::io_syscalls();
+        std::clock_t cpu_before = std::clock();
+        std::error_code ec;
+        for (auto _ : state) {
+            switch (Mode) {
+            case mode::associated:
+            case mode::timestamped: sent += sender.write(message, ec) == size; break;
+            case mode::unassociated: sent += sender.write(message, ec, target) == size; break;
+            case mode::native: sent += sender.write(message, ec, native_target) == size; break;
+            case mode::batched: sent += sender.write_batch(batch, ec); break;
+            case mode::segmented:
+            case mode::coalesced: sent += sender.write_segmented(segments, size, ec) / size; break;
+            }
+        }
+
+        // End marker can be dropped too if receiver is overloaded, so
+        // resend it until receiver sees it.
+        std::vector<uint8_t> end_marker(size + 1, 0xEF);
+        while (!done) {
+            sender.write(end_marker, ec, target);
+            std::this_thread::sleep_for(1ms);
+        }
+        receiver_thread.join();
+        std::clock_t cpu_after = std::clock();
+        uint64_t syscalls_after = bench::io_syscalls();
+
+        using benchmark::Counter;
+        state.counters["sent_pps"] = Counter(double(sent), Counter::kIsRate);
+        state.counters["received_pps"] = Counter(double(received), Counter::kIsRate);
+        state.counters["drop_rate"] = sent == 0 ? 0.0 : 1.0 - double(received) / double(sent);
+        if (received != 0) {
+            double cpu_ns = double(cpu_after - cpu_before) * 1e9 / CLOCKS_PER_SEC;
+            state.counters["cpu_ns_per_packet"] = cpu_ns / double(received);
+            state.counters["syscalls_per_packet"] = double(syscalls_after - syscalls_before) / double(received);
+        }
+        if (Mode == mode::timestamped && received != 0) {
+            state.counters["queue_delay_us"] = double(stats.queue_delay.count()) / 1e3 / double(received + 1);
+            state.counters["kernel_drops"] = double(stats.drops);
+        }
+        state.SetBytesProcessed(int64_t(received * size));
+    }
+
+    template<bool Steer>
+    void udp_group(benchmark::State& state) {
+        const auto count = size_t(state.range(0));
+        const size_t size = 64, client_count = 64;
+
+        udp::socket_group group({ipv4::loopback, 0}, count);
+        if (Steer) group.steer_by_cpu();
+
+        struct alignas(64) counter {
+            uint64_t value = 0;
+        };
+        std::vector<counter> received_by(count);
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> receivers;
+        for (size_t i = 0; i < count; ++i) {
+            receivers.emplace_back([&, i]() {
+                std::vector<uint8_t> buffer(size);
+                std::error_code ec;
+                for (;;) {
+                    udp::datagram_info info = group[i].read({buffer.data(), buffer.size()}, ec);
+                    if (stop) return;
+                    if (!ec && info.size == size) ++received_by[i].value;
+                }
+            });
+        }
+
+        std::vector<udp::socket> clients;
+        for (size_t i = 0; i < client_count; ++i) {
+            clients.emplace_back(ip::v4).associate(group.local_endpoint());
+        }
+
+        std::vector<uint8_t> message(size, 0xAB);
+        uint64_t sent = 0;
+        std::error_code ec;
+        size_t next_client = 0;
+        for (auto _ : state) {
+            sent += clients[next_client].write(message, ec) == size;
+            next_client = (next_client + 1) % client_count;
+        }
+
+        // Let receivers drain their queues, then wake them up.
+        std::this_thread::sleep_for(10ms);
+        stop = true;
+        for (udp::socket& s : group) s.implementation().shutdown(true, false);
+        for (std::thread& receiver : receivers) receiver.join();
+
+        uint64_t received = 0;
+        for (const counter& c : received_by) received += c.value;
+
+        using benchmark::Counter;
+        state.counters["sent_pps"] = Counter(double(sent), Counter::kIsRate);
+        state.counters["received_pps"] = Counter(double(received), Counter::kIsRate);
+        state.counters["drop_rate"] = sent == 0 ? 0.0 : 1.0 - double(received) / double(sent);
+    }
+
+    void sizes(benchmark::internal::Benchmark* b) {
+        b->ArgName("size");
+        b->Arg(16)->Arg(64)->Arg(512)->Arg(1400)->Arg(8192);
+        b->UseRealTime();
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(udp_blast, mode::associated)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::unassociated)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::native)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::batched)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::segmented)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::coalesced)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_blast, mode::timestamped)->Apply(sizes);
+BENCHMARK_TEMPLATE(udp_group, false)->ArgName("sockets")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(udp_group, true)->ArgName("sockets")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
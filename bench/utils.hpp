@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/**
+ * \file utils.hpp
+ *
+ * Helpers shared by I/O benchmark harnesses.
+ */
+
+namespace bench {
+    /**
+     * Get total count of socket I/O system calls (send/recv families,
+     * read/write and their vectored variants, pread, sendfile and splice)
+     * made by whole process so far.
+     *
+     * Counted by interposing libc wrappers (see syscalls.cpp), so only
+     * calls made through libc are visible. Returns 0 on platforms where
+     * interposition is not implemented.
+     */
+    uint64_t io_syscalls() noexcept;
+
+    /**
+     * Get p-th quantile (0..1) of samples. Samples are reordered.
+     */
+    template<typename T>
+    T percentile(std::vector<T>& samples, double p) {
+        if (samples.empty()) return T{};
+        size_t index = std::min(samples.size() - 1, size_t(p * double(samples.size())));
+        std::nth_element(samples.begin(), samples.begin() + std::ptrdiff_t(index), samples.end());
+        return samples[index];
+    }
+
+    /**
+     * Duration in microseconds as double, for benchmark counters.
+     */
+    inline double to_us(std::chrono::nanoseconds duration) {
+        return double(duration.count()) / 1000.0;
+    }
+} // namespace bench
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <libwire/tcp/listener.hpp>
+#include <libwire/tcp/buffered_socket.hpp>
 
 /**
  * \example echo_server.cpp
@@ -37,8 +38,8 @@ int main(int argc, char** argv) {
 
     std::string buf;
     while (true) {
-        auto sock = listener.accept();
-        endpoint source = sock.remote_endpoint();
+        tcp::buffered_socket sock{listener.accept()};
+        endpoint source = sock.next_layer().remote_endpoint();
 
         std::cout << "Accepted connection from " << source.to_string() << ".\n";
 
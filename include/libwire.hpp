@@ -10,4 +10,6 @@ namespace libwire {} // namespace libwire
 #include "libwire/address.hpp"
 #include "libwire/dns.hpp"
 #include "libwire/options.hpp"
+#include "libwire/reactor.hpp"
+#include "libwire/proactor.hpp"
 #include "libwire/tcp.hpp"
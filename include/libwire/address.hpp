@@ -24,10 +24,14 @@
 
 #include <cstdint>
 #include <array>
+#include <charconv>
+#include <iosfwd>
 #include <string_view>
 #include <string>
+#include <system_error>
 #include <libwire/protocols.hpp>
 #include <libwire/memory_view.hpp>
+#include <libwire/internal/hash.hpp>
 
 /**
  * \file address.hpp
@@ -104,9 +108,38 @@ namespace libwire {
          *
          * \warning Multiple consecutive zeros are NOT allowed
          *  "000.0.11.11" will throw.
+         *
+         * See also \ref parse which doesn't require std::string.
          */
         address(const std::string& text_ip, ip assume_ipver = ip(0)) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL);
 
+        /**
+         * Parse IP address from string, same rules as for constructor
+         * from std::string apply.
+         *
+         * Accepts dotted-quad IPv4 addresses and IPv6 addresses as
+         * described in RFC 4291 (including "::" compression and embedded
+         * IPv4 in last 32 bits), zone identifiers ("%eth0") are not
+         * supported. Doesn't allocate memory.
+         *
+         * On failure ec is set to \ref error::invalid_argument and
+         * \ref invalid is returned.
+         */
+        static address parse(std::string_view text_ip, std::error_code& ec, ip assume_ipver = ip(0)) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        static address parse(std::string_view text_ip, ip assume_ipver = ip(0));
+#endif // ifdef __cpp_exceptions
+
+        /**
+         * Maximum length of text representation of address, see \ref to_chars.
+         */
+        static constexpr size_t max_text_length = 45;
+
         /**
          * Convert address object to string representation.
          *
@@ -114,6 +147,17 @@ namespace libwire {
          */
         std::string to_string() const noexcept;
 
+        /**
+         * Write string representation of address (same as \ref to_string)
+         * into [first, last) range without memory allocations.
+         *
+         * Output is not null-terminated. Like std::to_chars, returns
+         * pointer past last written character or last and
+         * std::errc::value_too_large if range is too small, buffer of
+         * \ref max_text_length characters is always enough.
+         */
+        std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
         bool is_invalid() const noexcept;
 
         bool operator==(const address&) const noexcept;
@@ -141,14 +185,30 @@ namespace libwire {
                                     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
                        loopback = {0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x1};
     } // namespace ipv6
+
+    /**
+     * Write string representation of address to stream, uses
+     * address::to_chars so no temporary strings are allocated.
+     *
+     * {fmt} 10+ doesn't use operator<< automatically, opt in with
+     * \code
+     * template<> struct fmt::formatter<libwire::address> : fmt::ostream_formatter {};
+     * \endcode
+     */
+    std::ostream& operator<<(std::ostream&, const address&);
 } // namespace libwire
 
 namespace std {
     /**
      * Hash implementation for address.
+     *
+     * All 16 bytes of address are hashed as two 64-bit words, so it is
+     * cheap enough to be computed for each packet.
      */
     template<>
     struct hash<libwire::address> {
-        std::size_t operator()(const libwire::address&) const noexcept;
+        std::size_t operator()(const libwire::address& addr) const noexcept {
+            return std::size_t(libwire::internal_::hash_bytes16(addr.parts.data(), uint64_t(addr.version)));
+        }
     };
 } // namespace std
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <charconv>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <libwire/address.hpp>
+
+/**
+ * \file cidr.hpp
+ *
+ * This file defines network prefix (CIDR block) structure.
+ */
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+namespace libwire {
+    /**
+     * IPv4/IPv6 network prefix: address and count of leading bits
+     * that identify network (prefix length).
+     *
+     * Host bits of address (bits after prefix length) are always zero,
+     * so cidr({192, 168, 1, 1}, 24) is stored as 192.168.1.0/24 and two
+     * objects describing same network compare equal.
+     *
+     * See \ref prefix_table for longest-prefix-match lookups.
+     */
+    struct cidr {
+        address addr;
+        uint8_t prefix_length = 0;
+
+        /**
+         * Construct invalid prefix, same as \ref invalid.
+         */
+        cidr() noexcept = default;
+
+        /**
+         * Construct prefix from address and prefix length, host bits
+         * of address are cleared.
+         *
+         * prefix_length bigger than \ref max_prefix_length for address
+         * version is clamped to it.
+         */
+        cidr(const address& addr, uint8_t prefix_length) noexcept;
+
+        /**
+         * Parse prefix from string representation.
+         *
+         * Input should have following format: "IP/LENGTH" (for example,
+         * "10.0.0.0/8" or "2001:db8::/32"). If "/LENGTH" is omitted then
+         * prefix matches single address. Host bits are allowed and cleared.
+         *
+         * If exceptions are enabled - will throw std::invalid_argument,
+         * otherwise constructed prefix will have is_invalid() = true.
+         */
+        explicit cidr(std::string_view str) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL);
+
+        /**
+         * Parse prefix from string representation, same rules as for
+         * constructor from std::string_view apply. Doesn't allocate memory.
+         *
+         * On failure ec is set to \ref error::invalid_argument and
+         * \ref invalid is returned.
+         */
+        static cidr parse(std::string_view str, std::error_code& ec) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        static cidr parse(std::string_view str);
+#endif // ifdef __cpp_exceptions
+
+        /**
+         * Size of address of specified version in bits (32 or 128).
+         */
+        static uint8_t max_prefix_length(ip version) noexcept;
+
+        /**
+         * Check whether address belongs to network.
+         *
+         * Always false for addresses of other IP version.
+         */
+        bool contains(const address& address) const noexcept;
+
+        bool is_invalid() const noexcept;
+
+        /**
+         * Maximum length of text representation of prefix, see \ref to_chars.
+         */
+        static constexpr size_t max_text_length = address::max_text_length + 1 + 3; // IP/LEN
+
+        /**
+         * Convert prefix to string representation ("IP/LENGTH").
+         */
+        std::string to_string() const noexcept;
+
+        /**
+         * Write string representation of prefix (same as \ref to_string)
+         * into [first, last) range without memory allocations.
+         *
+         * Output is not null-terminated. Like std::to_chars, returns
+         * pointer past last written character or last and
+         * std::errc::value_too_large if range is too small.
+         */
+        std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
+        bool operator==(const cidr& rhs) const noexcept;
+        bool operator!=(const cidr& rhs) const noexcept;
+
+        static const cidr invalid;
+    };
+
+    /**
+     * Write string representation of prefix to stream.
+     */
+    std::ostream& operator<<(std::ostream&, const cidr&);
+} // namespace libwire
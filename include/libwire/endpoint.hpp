@@ -42,6 +42,24 @@ namespace libwire {
          */
         endpoint(const std::string_view& str) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL);
 
+        /**
+         * Parse endpoint information from string representation, same rules
+         * as for constructor from std::string_view apply. Port must be in
+         * range 1-65535. Doesn't allocate memory.
+         *
+         * On failure ec is set to \ref error::invalid_argument and
+         * \ref invalid is returned.
+         */
+        static endpoint parse(std::string_view str, std::error_code& ec) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        static endpoint parse(std::string_view str);
+#endif // ifdef __cpp_exceptions
+
         /**
          * Returns true if endpoint struct have invalid contents because
          * of c-tor failure.
@@ -57,9 +75,49 @@ namespace libwire {
          */
         std::string to_string() const noexcept;
 
+        /**
+         * Maximum length of text representation of endpoint, see \ref to_chars.
+         */
+        static constexpr size_t max_text_length = address::max_text_length + 2 + 1 + 5; // [IP]:PORT
+
+        /**
+         * Write string representation of endpoint (same as \ref to_string)
+         * into [first, last) range without memory allocations.
+         *
+         * Output is not null-terminated. Like std::to_chars, returns
+         * pointer past last written character or last and
+         * std::errc::value_too_large if range is too small, buffer of
+         * \ref max_text_length characters is always enough.
+         */
+        std::to_chars_result to_chars(char* first, char* last) const noexcept;
+
         bool operator==(const endpoint& rhs) const noexcept;
         bool operator!=(const endpoint& rhs) const noexcept;
 
         static const endpoint invalid;
     };
+
+    /**
+     * Write string representation of endpoint to stream, uses
+     * endpoint::to_chars so no temporary strings are allocated.
+     *
+     * See operator<< for address about using it with {fmt}.
+     */
+    std::ostream& operator<<(std::ostream&, const endpoint&);
 } // namespace libwire
+
+namespace std {
+    /**
+     * Hash implementation for endpoint.
+     *
+     * Port and IP version are mixed into address hash, so endpoints that
+     * differ only by port get unrelated hashes.
+     */
+    template<>
+    struct hash<libwire::endpoint> {
+        std::size_t operator()(const libwire::endpoint& ep) const noexcept {
+            uint64_t seed = uint64_t(ep.addr.version) | uint64_t(ep.port) << 8u;
+            return std::size_t(libwire::internal_::hash_bytes16(ep.addr.parts.data(), seed));
+        }
+    };
+} // namespace std
@@ -256,6 +256,12 @@ namespace libwire::error {
          * Remote side of connection finished transmission.
          */
         end_of_file,
+
+        /**
+         * Non-blocking operation can't be completed without
+         * blocking. Alias for \ref try_again.
+         */
+        would_block = try_again,
     };
 
     enum dns_condition {
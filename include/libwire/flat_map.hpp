@@ -0,0 +1,573 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <libwire/address.hpp>
+#include <libwire/endpoint.hpp>
+#include <libwire/internal/bits.hpp>
+#include <libwire/internal/platform.hpp>
+
+#if defined(LIBWIRE_SSE2)
+#    include <emmintrin.h>
+#endif
+
+/**
+ * \file flat_map.hpp
+ *
+ * This file defines flat open-addressing hash map and its aliases
+ * for address and endpoint keys, intended for per-peer state tables
+ * looked up on each received packet.
+ */
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+namespace libwire {
+    namespace internal_ {
+        /**
+         * Window of consecutive control bytes of flat_map, compared
+         * with single SSE2 instruction where available.
+         */
+        class control_group {
+        public:
+            static constexpr size_t width = 16;
+            static constexpr int8_t empty = -128;
+
+            explicit control_group(const int8_t* bytes) noexcept {
+#if defined(LIBWIRE_SSE2)
+                data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+#else
+                std::memcpy(data, bytes, width);
+#endif
+            }
+
+            /**
+             * Bitmask of bytes equal to tag, bit N corresponds to byte N.
+             */
+            uint32_t match(int8_t tag) const noexcept {
+#if defined(LIBWIRE_SSE2)
+                return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(tag))));
+#else
+                uint32_t mask = 0;
+                for (size_t i = 0; i < width; ++i) mask |= uint32_t(data[i] == tag) << i;
+                return mask;
+#endif
+            }
+
+            /**
+             * Bitmask of empty bytes, bit N corresponds to byte N.
+             */
+            uint32_t match_empty() const noexcept {
+#if defined(LIBWIRE_SSE2)
+                // Only empty marker has highest bit set.
+                return uint32_t(_mm_movemask_epi8(data));
+#else
+                return match(empty);
+#endif
+            }
+
+        private:
+#if defined(LIBWIRE_SSE2)
+            __m128i data;
+#else
+            int8_t data[width];
+#endif
+        };
+    } // namespace internal_
+
+    /**
+     * Hash map with open addressing and all elements stored inline in
+     * single array.
+     *
+     * Interface is a subset of std::unordered_map. Main differences are:
+     * - Any insertion or removal invalidates all iterators, pointers and
+     *   references to elements (elements are moved inside array).
+     * - erase(iterator) returns nothing, use \ref erase_if to remove
+     *   elements while iterating.
+     *
+     * Each slot has one control byte which is either empty marker or 7
+     * bits of key hash. Lookup uses linear probing, comparing 16 control
+     * bytes at once, so keys are compared only on (rare) tag match and
+     * miss usually costs single group check. Removal shifts following
+     * elements of probe sequence back (no tombstones are left), so
+     * lookups don't degrade in tables with high churn (like connections
+     * table).
+     *
+     * Table grows by doubling when it becomes 3/4 full. Quality of hash
+     * matters: both lowest (position) and highest (tag) bits are used,
+     * std::hash specializations for \ref address and \ref endpoint are
+     * good enough.
+     */
+    template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class flat_map {
+        struct slot;
+
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<const Key, T>;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        template<bool Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename flat_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+            basic_iterator() noexcept = default;
+
+            template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+                : control(other.control), control_end(other.control_end), current(other.current) {}
+
+            reference operator*() const noexcept {
+                return *current->get();
+            }
+
+            pointer operator->() const noexcept {
+                return current->get();
+            }
+
+            basic_iterator& operator++() noexcept {
+                ++control;
+                ++current;
+                skip_empty();
+                return *this;
+            }
+
+            basic_iterator operator++(int) noexcept {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const basic_iterator& o) const noexcept {
+                return current == o.current;
+            }
+
+            bool operator!=(const basic_iterator& o) const noexcept {
+                return current != o.current;
+            }
+
+        private:
+            friend class flat_map;
+            friend class basic_iterator<!Const>;
+
+            basic_iterator(const int8_t* control, const int8_t* control_end, slot* current) noexcept
+                : control(control), control_end(control_end), current(current) {}
+
+            void skip_empty() noexcept {
+                while (control != control_end && *control == internal_::control_group::empty) {
+                    ++control;
+                    ++current;
+                }
+            }
+
+            const int8_t* control = nullptr;
+            const int8_t* control_end = nullptr;
+            slot* current = nullptr;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        /**
+         * Construct empty map, doesn't allocate memory.
+         */
+        flat_map() noexcept = default;
+
+        /**
+         * Construct empty map with space for at least expected_size
+         * elements, see \ref reserve.
+         */
+        explicit flat_map(size_type expected_size) {
+            reserve(expected_size);
+        }
+
+        flat_map(const flat_map& other) : hash(other.hash), equal(other.equal) {
+            reserve(other.size());
+            for (const auto& value : other) try_emplace(value.first, value.second);
+        }
+
+        flat_map(flat_map&& other) noexcept {
+            swap(other);
+        }
+
+        flat_map& operator=(const flat_map& other) {
+            if (this != &other) {
+                flat_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        flat_map& operator=(flat_map&& other) noexcept {
+            flat_map moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        ~flat_map() {
+            destroy_all();
+        }
+
+        iterator begin() noexcept {
+            return make_iterator(0);
+        }
+
+        iterator end() noexcept {
+            return iterator(control.get() + slots_count, control.get() + slots_count, slots.get() + slots_count);
+        }
+
+        const_iterator begin() const noexcept {
+            return const_cast<flat_map*>(this)->begin();
+        }
+
+        const_iterator end() const noexcept {
+            return const_cast<flat_map*>(this)->end();
+        }
+
+        bool empty() const noexcept {
+            return elements == 0;
+        }
+
+        size_type size() const noexcept {
+            return elements;
+        }
+
+        /**
+         * Count of slots in table, not all of them can be used before
+         * table grows.
+         */
+        size_type capacity() const noexcept {
+            return slots_count;
+        }
+
+        /**
+         * Destroy all elements, capacity is not changed.
+         */
+        void clear() noexcept {
+            if (slots_count == 0) return;
+            destroy_all();
+            std::memset(control.get(), internal_::control_group::empty, control_size());
+            elements = 0;
+            growth_left = max_load(slots_count);
+        }
+
+        /**
+         * Grow table so count elements can be inserted without growing.
+         */
+        void reserve(size_type count) {
+            size_type new_count = internal_::control_group::width;
+            while (max_load(new_count) < count) new_count *= 2;
+            if (new_count > slots_count) rehash(new_count);
+        }
+
+        iterator find(const Key& key) noexcept {
+            if (elements == 0) return end();
+            auto [index, found] = lookup(key, hash(key));
+            return found ? make_iterator(index) : end();
+        }
+
+        const_iterator find(const Key& key) const noexcept {
+            return const_cast<flat_map*>(this)->find(key);
+        }
+
+        bool contains(const Key& key) const noexcept {
+            return find(key) != end();
+        }
+
+        size_type count(const Key& key) const noexcept {
+            return contains(key) ? 1 : 0;
+        }
+
+        /**
+         * Insert value constructed from args if key is not present.
+         *
+         * Returns iterator to element with key and true if insertion
+         * happened.
+         */
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+            size_t key_hash = hash(key);
+            size_t index = 0;
+            if (slots_count != 0) {
+                bool found;
+                std::tie(index, found) = lookup(key, key_hash);
+                if (found) return {make_iterator(index), false};
+            }
+            if (growth_left == 0) {
+                rehash(slots_count == 0 ? internal_::control_group::width : slots_count * 2);
+                index = first_empty(key_hash);
+            }
+
+            new (slots[index].storage) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                                  std::forward_as_tuple(std::forward<Args>(args)...));
+            set_control(index, tag_of(key_hash));
+            ++elements;
+            --growth_left;
+            return {make_iterator(index), true};
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value) {
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if (!result.second) result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        T& operator[](const Key& key) {
+            return try_emplace(key).first->second;
+        }
+
+        /**
+         * Remove element with key, returns count of removed elements.
+         */
+        size_type erase(const Key& key) {
+            if (elements == 0) return 0;
+            auto [index, found] = lookup(key, hash(key));
+            if (!found) return 0;
+            erase_at(index);
+            return 1;
+        }
+
+        /**
+         * Remove element pointed by iterator.
+         */
+        void erase(const_iterator pos) {
+            erase_at(size_t(pos.current - slots.get()));
+        }
+
+        /**
+         * Remove all elements for which pred returns true, returns count of
+         * removed elements.
+         *
+         * Predicate is called exactly once for each element.
+         */
+        template<typename Pred>
+        size_type erase_if(Pred pred) {
+            if (elements == 0) return 0;
+
+            // Elements are never moved over empty slot, so if we start right
+            // after one and go around, shifted elements are never visited twice.
+            size_t start = 0;
+            while (control[start] != internal_::control_group::empty) ++start;
+
+            size_type removed = 0;
+            for (size_t i = 1; i < slots_count; ++i) {
+                size_t index = (start + i) & (slots_count - 1);
+                while (control[index] != internal_::control_group::empty && pred(*slots[index].get())) {
+                    erase_at(index);
+                    ++removed;
+                }
+            }
+            return removed;
+        }
+
+        void swap(flat_map& other) noexcept {
+            using std::swap;
+            swap(control, other.control);
+            swap(slots, other.slots);
+            swap(slots_count, other.slots_count);
+            swap(elements, other.elements);
+            swap(growth_left, other.growth_left);
+            swap(hash, other.hash);
+            swap(equal, other.equal);
+        }
+
+    private:
+        struct slot {
+            alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+            value_type* get() noexcept {
+                return std::launder(reinterpret_cast<value_type*>(storage));
+            }
+        };
+
+        static constexpr size_t npos = size_t(-1);
+
+        static size_type max_load(size_type count) noexcept {
+            return count - count / 4;
+        }
+
+        static int8_t tag_of(size_t key_hash) noexcept {
+            return int8_t(key_hash >> (sizeof(size_t) * 8 - 7));
+        }
+
+        // Control bytes array has copy of first (width - 1) bytes at the
+        // end so group can be loaded from any position without wrapping.
+        size_t control_size() const noexcept {
+            return slots_count + internal_::control_group::width - 1;
+        }
+
+        void set_control(size_t index, int8_t value) noexcept {
+            control[index] = value;
+            if (index < internal_::control_group::width - 1) control[slots_count + index] = value;
+        }
+
+        iterator make_iterator(size_t index) noexcept {
+            iterator it(control.get() + index, control.get() + slots_count, slots.get() + index);
+            it.skip_empty();
+            return it;
+        }
+
+        /**
+         * Find slot with key or first empty slot of probe sequence if key
+         * is not present. Table should be allocated.
+         */
+        std::pair<size_t, bool> lookup(const Key& key, size_t key_hash) noexcept {
+            const size_t mask = slots_count - 1;
+            const int8_t tag = tag_of(key_hash);
+            size_t position = key_hash & mask;
+            while (true) {
+                internal_::control_group group(control.get() + position);
+                for (uint32_t match = group.match(tag); match != 0; match &= match - 1) {
+                    size_t index = (position + internal_::lowest_bit(match)) & mask;
+                    if (equal(slots[index].get()->first, key)) return {index, true};
+                }
+                uint32_t empty = group.match_empty();
+                if (empty != 0) return {(position + internal_::lowest_bit(empty)) & mask, false};
+                position = (position + internal_::control_group::width) & mask;
+            }
+        }
+
+        size_t first_empty(size_t key_hash) const noexcept {
+            const size_t mask = slots_count - 1;
+            size_t position = key_hash & mask;
+            while (true) {
+                uint32_t empty = internal_::control_group(control.get() + position).match_empty();
+                if (empty != 0) return (position + internal_::lowest_bit(empty)) & mask;
+                position = (position + internal_::control_group::width) & mask;
+            }
+        }
+
+        void relocate(size_t from, slot* to) noexcept {
+            new (to->storage) value_type(std::move(*slots[from].get()));
+            slots[from].get()->~value_type();
+        }
+
+        void erase_at(size_t index) {
+            const size_t mask = slots_count - 1;
+            slots[index].get()->~value_type();
+
+            // Backward shift: move elements of the same probe sequence
+            // into hole unless it is before their home position.
+            size_t hole = index;
+            for (size_t i = (index + 1) & mask; control[i] != internal_::control_group::empty; i = (i + 1) & mask) {
+                size_t home = hash(slots[i].get()->first) & mask;
+                if (((i - home) & mask) >= ((i - hole) & mask)) {
+                    relocate(i, &slots[hole]);
+                    set_control(hole, control[i]);
+                    hole = i;
+                }
+            }
+            set_control(hole, internal_::control_group::empty);
+            --elements;
+            ++growth_left;
+        }
+
+        void rehash(size_type new_count) {
+            flat_map grown;
+            // Not value-initialized intentionally, slots are constructed on insertion.
+            grown.control.reset(new int8_t[new_count + internal_::control_group::width - 1]);
+            grown.slots.reset(new slot[new_count]);
+            grown.slots_count = new_count;
+            std::memset(grown.control.get(), internal_::control_group::empty, grown.control_size());
+
+            for (size_t i = 0; i < slots_count; ++i) {
+                if (control[i] == internal_::control_group::empty) continue;
+                size_t key_hash = hash(slots[i].get()->first);
+                size_t index = grown.first_empty(key_hash);
+                relocate(i, &grown.slots[index]);
+                control[i] = internal_::control_group::empty;
+                grown.set_control(index, tag_of(key_hash));
+            }
+
+            grown.elements = elements;
+            grown.growth_left = max_load(new_count) - elements;
+            elements = 0;
+            control.swap(grown.control);
+            slots.swap(grown.slots);
+            std::swap(slots_count, grown.slots_count);
+            std::swap(elements, grown.elements);
+            std::swap(growth_left, grown.growth_left);
+        }
+
+        void destroy_all() noexcept {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_t i = 0; i < slots_count; ++i) {
+                    if (control[i] != internal_::control_group::empty) slots[i].get()->~value_type();
+                }
+            }
+        }
+
+        std::unique_ptr<int8_t[]> control;
+        std::unique_ptr<slot[]> slots;
+        size_type slots_count = 0;
+        size_type elements = 0;
+        size_type growth_left = 0;
+        Hash hash;
+        KeyEqual equal;
+    };
+
+    /**
+     * Flat hash map keyed by endpoint, see \ref flat_map.
+     */
+    template<typename T>
+    using endpoint_map = flat_map<endpoint, T>;
+
+    /**
+     * Flat hash map keyed by address, see \ref flat_map.
+     */
+    template<typename T>
+    using address_map = flat_map<address, T>;
+} // namespace libwire
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+/**
+ * This file defines portable bit manipulation helpers (C++20 <bit>
+ * equivalents) used by libwire containers.
+ *
+ * Despite not being part of public API interface of these functions
+ * probably will not be changed, so you can use them if you really
+ * want.
+ */
+
+namespace libwire::internal_ {
+    /**
+     * Index of lowest set bit, mask should be non-zero.
+     */
+    inline unsigned lowest_bit(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+        return unsigned(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return unsigned(index);
+#else
+        unsigned index = 0;
+        while ((mask & 1u) == 0) {
+            mask >>= 1u;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    /**
+     * Index of highest set bit, mask should be non-zero.
+     */
+    inline unsigned highest_bit(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+        return 63u - unsigned(__builtin_clzll(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, mask);
+        return unsigned(index);
+#else
+        unsigned index = 0;
+        while (mask >>= 1u) ++index;
+        return index;
+#endif
+    }
+
+    /**
+     * Count of set bits.
+     */
+    inline unsigned popcount(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+        return unsigned(__builtin_popcountll(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return unsigned(__popcnt64(mask));
+#else
+        unsigned count = 0;
+        for (; mask != 0; mask &= mask - 1) ++count;
+        return count;
+#endif
+    }
+} // namespace libwire::internal_
@@ -29,6 +29,9 @@
 #include <libwire/protocols.hpp>
 #include <libwire/internal/platform.hpp>
 #include <libwire/endpoint.hpp>
+#include <libwire/native_endpoint.hpp>
+#include <libwire/memory_view.hpp>
+#include <libwire/udp/datagram.hpp>
 
 namespace libwire::internal_ {
     /**
@@ -43,6 +46,17 @@ namespace libwire::internal_ {
         // Actually SOCKET type, but defined here as ULL to avoid inclusion of system headers.
 #endif
 
+        /**
+         * Type of regular file descriptor accepted by \ref sendfile.
+         */
+#if defined(LIBWIRE_POSIX)
+        using native_file_t = int;
+#endif
+#if defined(LIBWIRE_WINDOWS)
+        using native_file_t = void*;
+        // Actually HANDLE, but defined here to avoid inclusion of system headers.
+#endif
+
         static unsigned max_pending_connections;
 
         /**
@@ -59,6 +73,27 @@ namespace libwire::internal_ {
         // Actually INVALID_SOCKET, but defined here to avoid inclusion of system headers.
 #endif
 
+        /**
+         * Bit flags applied to newly created sockets. Where possible they are
+         * passed directly to socket()/accept4() (SOCK_NONBLOCK, SOCK_CLOEXEC),
+         * otherwise separate system calls are used.
+         *
+         * Public socket types always pass close_on_exec.
+         */
+        enum flag : unsigned {
+            /**
+             * Create socket in non-blocking mode, same as
+             * set_option(non_blocking, true) after creation.
+             */
+            non_blocking = 1u << 0u,
+
+            /**
+             * Don't inherit socket descriptor to child processes
+             * created by exec().
+             */
+            close_on_exec = 1u << 1u,
+        };
+
         /**
          * Construct handle without allocating socket.
          */
@@ -70,8 +105,10 @@ namespace libwire::internal_ {
         /**
          * Allocate new socket with specified family (network protocol)
          * and socket type (transport protocol).
+         *
+         * flags is a bit mask of \ref flag values.
          */
-        socket(ip ipver, transport transport, std::error_code& ec) noexcept;
+        socket(ip ipver, transport transport, std::error_code& ec, unsigned flags = 0) noexcept;
 
         socket(const socket&) = delete;
         socket(socket&&) noexcept;
@@ -104,6 +141,16 @@ namespace libwire::internal_ {
          */
         void bind(endpoint target, std::error_code& ec) noexcept;
 
+        /**
+         * Allow multiple sockets to bind to the same endpoint (SO_REUSEPORT),
+         * kernel will distribute incoming connections/datagrams between them.
+         * Must be called before \ref bind.
+         *
+         * ec will be set to std::errc::not_supported on platforms without
+         * SO_REUSEPORT.
+         */
+        void reuse_port(bool enable, std::error_code& ec) noexcept;
+
         /**
          * Start accepting connections on this listener socket.
          *
@@ -115,8 +162,13 @@ namespace libwire::internal_ {
         /**
          * Extract and accept first connection from queue and create socket for it,
          * set ec if any error occurred.
+         *
+         * If peer is not null - remote endpoint of accepted connection will be
+         * written to it.
+         *
+         * flags is a bit mask of \ref flag values applied to accepted socket.
          */
-        socket accept(std::error_code& ec) noexcept;
+        socket accept(std::error_code& ec, endpoint* peer = nullptr, unsigned flags = 0) noexcept;
 
         /**
          * Write length_bytes from input to socket, set ec if any error
@@ -130,6 +182,38 @@ namespace libwire::internal_ {
          */
         size_t read(void* output, size_t length_bytes, std::error_code& ec) noexcept;
 
+        /**
+         * Maximum count of buffers passed to one \ref writev or
+         * \ref readv call, remaining buffers are ignored.
+         */
+        static constexpr size_t max_buffers = 64;
+
+        /**
+         * Gather version of write, writes buffers in order using one system
+         * call, set ec if any error occurred and return real count of data
+         * written.
+         */
+        size_t writev(const memory_view* buffers, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Scatter version of read, fills buffers in order using one system
+         * call, set ec if any error occurred and return real count of data
+         * read.
+         */
+        size_t readv(const memory_view* buffers, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Write up to length_bytes from file starting at offset to socket,
+         * set ec if any error occurred and return real count of data written.
+         *
+         * Uses sendfile() where available so file data is passed to socket
+         * by kernel without copying it to user space, otherwise data is read
+         * using pread() into intermediate buffer.
+         *
+         * If file ends before offset then ec is set to EOF.
+         */
+        size_t sendfile(native_file_t file, uint64_t offset, size_t length_bytes, std::error_code& ec) noexcept;
+
         /**
          * Connect to AF_UNSPEC.
          * This will undo connect() for UDP socket.
@@ -140,11 +224,97 @@ namespace libwire::internal_ {
          * Version of write for UDP sockets, uses dest instead of destination set using connect().
          */
         size_t sendto(const void* input, size_t length_bytes, endpoint dest, std::error_code& ec) noexcept;
+        size_t sendto(const void* input, size_t length_bytes, const native_endpoint& dest, std::error_code& ec) noexcept;
 
         /**
          * Version of read for UDP sockets, writes datagram source to source tuple passed by reference.
          */
         size_t recvfrom(void* output, size_t length_bytes, endpoint& source, std::error_code& ec) noexcept;
+        size_t recvfrom(void* output, size_t length_bytes, native_endpoint& source, std::error_code& ec) noexcept;
+
+        /**
+         * Versions of recvfrom and sendto for UDP sockets which also pass
+         * local side of datagram (see udp::packet_info) using
+         * IP_PKTINFO/IPV6_PKTINFO control messages. Report
+         * not_supported where these are not available.
+         *
+         * destination is left unchanged if socket doesn't have
+         * udp::receive_packet_info option enabled. ec is set to
+         * no_buffer_space if control data was truncated by kernel
+         * (MSG_CTRUNC).
+         */
+        size_t recvfrom(void* output, size_t length_bytes, native_endpoint& source, udp::packet_info& destination,
+                        std::error_code& ec) noexcept;
+        size_t sendto(const void* input, size_t length_bytes, const native_endpoint& dest,
+                      const udp::packet_info& source, std::error_code& ec) noexcept;
+
+        /**
+         * Version of recvfrom for UDP sockets which reports datagrams coalesced
+         * into output by generic receive offload (UDP_GRO), see
+         * udp::coalesced_datagram. source may be null.
+         *
+         * Received data is never larger than output buffer, excess is discarded
+         * and reported using truncated flag.
+         *
+         * Sets ec to no_buffer_space if control data was truncated by kernel
+         * (MSG_CTRUNC), because segment size is unknown then.
+         */
+        udp::coalesced_datagram recv_coalesced(memory_view output, native_endpoint* source,
+                                               std::error_code& ec) noexcept;
+
+        /**
+         * Version of recvfrom for UDP sockets which also reports receive
+         * timestamp and drop counter (SO_TIMESTAMPNS and SO_RXQ_OVFL control
+         * messages), see udp::datagram_info. Only source is reported where
+         * these are not available.
+         *
+         * Sets ec to no_buffer_space if control data was truncated by kernel
+         * (MSG_CTRUNC) instead of silently returning incomplete information.
+         */
+        udp::datagram_info recv_info(memory_view output, std::error_code& ec) noexcept;
+
+        /**
+         * Maximum count of segments kernel accepts in one datagram passed
+         * to \ref sendto_segmented.
+         */
+        static constexpr size_t max_segments = 64;
+
+        /**
+         * Version of sendto for UDP sockets which splits input into datagrams
+         * of segment_size bytes (last one may be shorter), uses destination
+         * set using connect() if dest is invalid. Set ec if any error occurred
+         * and return count of bytes sent, always multiple of segment_size
+         * unless entire input is sent.
+         *
+         * Uses generic segmentation offload (UDP_SEGMENT) where available,
+         * so kernel splits large buffer into datagrams itself, up to
+         * \ref max_datagrams such buffers are passed using one system call.
+         * Otherwise datagrams are sent one by one (using sendmmsg if
+         * available).
+         */
+        size_t sendto_segmented(const void* input, size_t length_bytes, size_t segment_size,
+                                const native_endpoint& dest, std::error_code& ec) noexcept;
+
+        /**
+         * Maximum count of datagrams processed by one \ref recvmmsg or
+         * \ref sendmmsg call, remaining datagrams are ignored.
+         */
+        static constexpr size_t max_datagrams = 64;
+
+        /**
+         * Receive up to count datagrams using one system call (where
+         * supported), set ec if any error occurred and return count of
+         * datagrams received.
+         *
+         * Blocks only until first datagram is available.
+         */
+        size_t recvmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Send up to count datagrams using one system call (where supported),
+         * set ec if any error occurred and return count of datagrams sent.
+         */
+        size_t sendmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept;
 
         /**
          * Allows to check whether socket is initialized and can be operated on.
@@ -158,8 +328,18 @@ namespace libwire::internal_ {
         native_handle_t handle = not_initialized;
 
         struct state {
-            // Set if user did set_option(non_blocking, ...);
+            // Set if socket was created with non_blocking flag or user did
+            // set_option(non_blocking, true).
             bool user_non_blocking : 1;
+
+            // Set after first sendto_segmented call, support of UDP_SEGMENT
+            // for this socket is stored in segmentation_offload.
+            bool segmentation_probed : 1;
+            bool segmentation_offload : 1;
+
+            // Set if socket was created with ip::v6, unknown for sockets
+            // constructed from native handle.
+            bool ipv6 : 1;
         } state{};
     };
 } // namespace libwire::internal_
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * This file defines hashing primitives used by std::hash
+ * specializations of libwire types.
+ *
+ * Despite not being part of public API interface of these functions
+ * probably will not be changed, so you can use them if you really
+ * want.
+ */
+
+namespace libwire::internal_ {
+    /**
+     * Finalization step of MurmurHash3 (fmix64), all input bits
+     * affect all output bits.
+     */
+    inline uint64_t hash_mix(uint64_t value) noexcept {
+        value ^= value >> 33u;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33u;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33u;
+        return value;
+    }
+
+    /**
+     * Hash 16 bytes pointed by data as two 64-bit words mixed with seed.
+     *
+     * Seed is offset by golden ratio constant so all-zero input with zero
+     * seed does not hash to zero.
+     */
+    inline uint64_t hash_bytes16(const uint8_t* data, uint64_t seed) noexcept {
+        uint64_t low, high;
+        std::memcpy(&low, data, sizeof(low));
+        std::memcpy(&high, data + sizeof(low), sizeof(high));
+        return hash_mix(hash_mix(low ^ (seed + 0x9e3779b97f4a7c15ull)) ^ high);
+    }
+} // namespace libwire::internal_
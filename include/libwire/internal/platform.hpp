@@ -36,4 +36,8 @@
 
 #if defined(_WIN32) || defined(WIN32) || defined(__WIN32) || defined(WINNT)
 #    define LIBWIRE_WINDOWS
-#endif
\ No newline at end of file
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define LIBWIRE_SSE2
+#endif
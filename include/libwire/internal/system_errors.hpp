@@ -40,6 +40,12 @@ namespace libwire::internal_ {
      */
     std::error_code last_system_error(int status = -1) noexcept;
 
+    /**
+     * Get system error code equivalent to error::invalid_argument,
+     * used for errors detected by library itself (i.e. parsing).
+     */
+    std::error_code invalid_argument_error() noexcept;
+
     class system_errors : public std::error_category {
     public:
         virtual const char* name() const noexcept override;
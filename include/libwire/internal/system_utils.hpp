@@ -52,9 +52,9 @@ namespace libwire::internal_ {
      */
     template<typename Func, typename... Args>
     auto error_wrapper(const Func& func, std::error_code& ec, Args&&... args) {
-        ec = std::error_code();
         decltype(func(std::forward<Args>(args)...)) res;
         do {
+            ec = std::error_code();
             res = func(std::forward<Args>(args)...);
             if (res < 0) {
                 ec = last_system_error();
@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <libwire/endpoint.hpp>
+
+/**
+ * \file native_endpoint.hpp
+ *
+ * This file defines endpoint representation used by operating system.
+ */
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+namespace libwire {
+    namespace internal_ {
+        struct socket;
+    } // namespace internal_
+
+    /**
+     * Endpoint stored in form accepted by operating system: sockaddr_in
+     * or sockaddr_in6 with its real size.
+     *
+     * \ref endpoint has to be converted to this form on each sendto call
+     * and received address is converted back on each recvfrom. If you
+     * send many datagrams to same peer (or reply to peer datagram just
+     * came from) then keep native_endpoint instead and pass it to
+     * udp::socket::read and udp::socket::write, no conversion is done then.
+     *
+     * Conversion to and from \ref endpoint is explicit because it's
+     * exactly what this type is intended to avoid.
+     */
+    class native_endpoint {
+    public:
+        /**
+         * Maximum size of stored socket address (sizeof(sockaddr_in6)).
+         */
+        static constexpr size_t capacity = 28;
+
+        /**
+         * Construct invalid endpoint.
+         */
+        native_endpoint() noexcept = default;
+
+        /**
+         * Convert endpoint to socket address. Port 0 is kept as is
+         * (it's used to bind to any free port), only endpoint with
+         * invalid address gives invalid native_endpoint.
+         */
+        explicit native_endpoint(const endpoint& ep) noexcept;
+
+        endpoint to_endpoint() const noexcept;
+
+        /**
+         * IP version of endpoint, ip(0) for invalid endpoint.
+         */
+        ip version() const noexcept;
+
+        bool is_invalid() const noexcept;
+
+        /**
+         * Pointer to socket address (sockaddr*) to be passed to system
+         * functions.
+         */
+        const void* data() const noexcept {
+            return storage;
+        }
+
+        /**
+         * Size of socket address in bytes (socklen_t), 0 for invalid
+         * endpoint.
+         */
+        size_t size() const noexcept {
+            return length;
+        }
+
+        /**
+         * Compare address family, address and port.
+         */
+        bool operator==(const native_endpoint& rhs) const noexcept;
+        bool operator!=(const native_endpoint& rhs) const noexcept;
+
+    private:
+        friend struct internal_::socket;
+
+        alignas(uint32_t) unsigned char storage[capacity] = {};
+        uint32_t length = 0;
+    };
+} // namespace libwire
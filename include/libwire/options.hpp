@@ -40,7 +40,7 @@ namespace libwire {
         }
 
     private:
-        static bool get_impl(internal_::socket&) noexcept;
+        static bool get_impl(const internal_::socket&) noexcept;
         static void set_impl(internal_::socket&, bool) noexcept;
     };
 
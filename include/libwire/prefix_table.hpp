@@ -0,0 +1,488 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+#include <libwire/address.hpp>
+#include <libwire/cidr.hpp>
+#include <libwire/internal/bits.hpp>
+
+/**
+ * \file prefix_table.hpp
+ *
+ * This file defines table of IPv4/IPv6 network prefixes with
+ * longest-prefix-match lookup.
+ */
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+namespace libwire {
+    namespace internal_ {
+        /**
+         * Count of address bits consumed by one node of tree bitmap.
+         */
+        constexpr unsigned trie_stride = 6;
+
+        /**
+         * For each stride-bits chunk - mask of internal bitmap positions
+         * of prefixes (shorter than stride) matching this chunk.
+         */
+        constexpr std::array<uint64_t, 1u << trie_stride> make_prefix_match_masks() noexcept {
+            std::array<uint64_t, 1u << trie_stride> masks{};
+            for (unsigned chunk = 0; chunk < masks.size(); ++chunk) {
+                for (unsigned length = 0; length < trie_stride; ++length) {
+                    masks[chunk] |= uint64_t(1) << ((1u << length) - 1 + (chunk >> (trie_stride - length)));
+                }
+            }
+            return masks;
+        }
+
+        inline constexpr auto prefix_match_masks = make_prefix_match_masks();
+
+        /**
+         * Count of trie levels skipped by direct lookup table.
+         */
+        constexpr unsigned trie_direct_levels = 2;
+        constexpr unsigned trie_direct_bits = trie_direct_levels * trie_stride;
+
+        /**
+         * Storage for blocks of 1-64 elements addressed by index of first
+         * element. Released blocks are reused for blocks of same size.
+         *
+         * Elements are wrapped into slot so E = bool doesn't hit
+         * std::vector<bool> which can't hand out references.
+         */
+        template<typename E>
+        class block_pool {
+        public:
+            static constexpr size_t max_block = 64;
+
+            uint32_t allocate(size_t count) {
+                assert(count > 0 && count <= max_block);
+                auto& free = free_blocks[count];
+                if (!free.empty()) {
+                    uint32_t index = free.back();
+                    free.pop_back();
+                    return index;
+                }
+                auto index = uint32_t(storage.size());
+                storage.resize(storage.size() + count);
+                return index;
+            }
+
+            void release(uint32_t index, size_t count) {
+                for (size_t i = 0; i < count; ++i) storage[index + i].value = E();
+                free_blocks[count].push_back(index);
+            }
+
+            void clear() noexcept {
+                storage.clear();
+                for (auto& free : free_blocks) free.clear();
+            }
+
+            E& operator[](size_t index) noexcept {
+                return storage[index].value;
+            }
+
+            const E& operator[](size_t index) const noexcept {
+                return storage[index].value;
+            }
+
+        private:
+            struct slot {
+                E value{};
+            };
+
+            std::vector<slot> storage;
+            std::array<std::vector<uint32_t>, max_block + 1> free_blocks;
+        };
+
+        /**
+         * Multibit trie with popcount-compressed nodes (Tree Bitmap,
+         * Eatherton et al.) over big-endian 16-byte address.
+         *
+         * Each node consumes trie_stride bits of address. It stores
+         * prefixes ending inside of these bits in internal bitmap (bit
+         * 2^length - 1 + value) and present children in external bitmap,
+         * values and children are kept in contiguous blocks indexed by
+         * popcount of lower bits. So lookup touches one node per stride
+         * and one value at end.
+         *
+         * Like in Poptrie, first trie_direct_bits of address are
+         * resolved by direct table pointing to nodes of corresponding
+         * level, so lookup of long prefix skips top levels of trie.
+         */
+        template<typename T>
+        class tree_bitmap {
+        public:
+            tree_bitmap() {
+                clear();
+            }
+
+            void clear() {
+                nodes.clear();
+                values.clear();
+                nodes.allocate(1); // Root.
+                direct.assign(size_t(1) << trie_direct_bits, 0);
+            }
+
+            template<typename V>
+            bool insert_or_assign(const uint8_t* bytes, unsigned length, V&& value) {
+                uint32_t index = 0;
+                unsigned offset = 0;
+                for (; length - offset >= trie_stride; offset += trie_stride) {
+                    index = make_child(index, chunk(bytes, offset), bytes, offset);
+                }
+
+                uint64_t bit = uint64_t(1) << prefix_position(bytes, offset, length - offset);
+                node current = nodes[index];
+                unsigned rank = popcount(current.internal & (bit - 1));
+                if ((current.internal & bit) != 0) {
+                    values[current.results + rank] = std::forward<V>(value);
+                    return false;
+                }
+
+                unsigned count = popcount(current.internal);
+                uint32_t block = values.allocate(count + 1);
+                for (unsigned i = 0; i < rank; ++i) values[block + i] = std::move(values[current.results + i]);
+                values[block + rank] = std::forward<V>(value);
+                for (unsigned i = rank; i < count; ++i) values[block + i + 1] = std::move(values[current.results + i]);
+                if (count != 0) values.release(current.results, count);
+
+                nodes[index].results = block;
+                nodes[index].internal |= bit;
+                return true;
+            }
+
+            bool erase(const uint8_t* bytes, unsigned length) {
+                std::array<uint32_t, 128 / trie_stride + 1> path;
+                std::array<unsigned, 128 / trie_stride + 1> path_chunks;
+                size_t depth = 0;
+
+                uint32_t index = 0;
+                unsigned offset = 0;
+                for (; length - offset >= trie_stride; offset += trie_stride) {
+                    unsigned chunk_value = chunk(bytes, offset);
+                    const node& current = nodes[index];
+                    if ((current.external >> chunk_value & 1u) == 0) return false;
+                    path[depth] = index;
+                    path_chunks[depth] = chunk_value;
+                    ++depth;
+                    index = current.children + popcount(current.external & ((uint64_t(1) << chunk_value) - 1));
+                }
+
+                uint64_t bit = uint64_t(1) << prefix_position(bytes, offset, length - offset);
+                node current = nodes[index];
+                if ((current.internal & bit) == 0) return false;
+
+                unsigned rank = popcount(current.internal & (bit - 1));
+                unsigned count = popcount(current.internal);
+                uint32_t block = 0;
+                if (count > 1) {
+                    block = values.allocate(count - 1);
+                    for (unsigned i = 0; i < rank; ++i) values[block + i] = std::move(values[current.results + i]);
+                    for (unsigned i = rank + 1; i < count; ++i) {
+                        values[block + i - 1] = std::move(values[current.results + i]);
+                    }
+                }
+                values.release(current.results, count);
+                nodes[index].results = block;
+                nodes[index].internal &= ~bit;
+
+                // Remove nodes left without prefixes and children.
+                while (depth != 0 && nodes[index].internal == 0 && nodes[index].external == 0) {
+                    --depth;
+                    remove_child(path[depth], path_chunks[depth], bytes, unsigned(depth) * trie_stride);
+                    index = path[depth];
+                }
+                return true;
+            }
+
+            const T* find(const uint8_t* bytes, unsigned length) const noexcept {
+                const node* current = &nodes[0];
+                unsigned offset = 0;
+                for (; length - offset >= trie_stride; offset += trie_stride) {
+                    unsigned chunk_value = chunk(bytes, offset);
+                    if ((current->external >> chunk_value & 1u) == 0) return nullptr;
+                    current = &nodes[current->children
+                                     + popcount(current->external & ((uint64_t(1) << chunk_value) - 1))];
+                }
+
+                uint64_t bit = uint64_t(1) << prefix_position(bytes, offset, length - offset);
+                if ((current->internal & bit) == 0) return nullptr;
+                return &values[current->results + popcount(current->internal & (bit - 1))];
+            }
+
+            const T* lookup(const uint8_t* bytes) const noexcept {
+                // Whole address as 128-bit big-endian number, so chunks are
+                // extracted by shifts.
+                uint64_t high = load_big_endian(bytes), low = load_big_endian(bytes + 8);
+
+                uint32_t start = direct[high >> (64u - trie_direct_bits)];
+                if (start != 0) {
+                    // All prefixes longer than trie_direct_bits are below start node.
+                    const T* result = descend(nodes[start], (high << trie_direct_bits) | (low >> (64u - trie_direct_bits)),
+                                              low << trie_direct_bits, 128 / trie_stride + 1);
+                    if (result != nullptr) return result;
+                }
+                return descend(nodes[0], high, low, trie_direct_levels);
+            }
+
+        private:
+            struct node {
+                uint64_t internal = 0;
+                uint64_t external = 0;
+                uint32_t children = 0;
+                uint32_t results = 0;
+            };
+
+            /**
+             * Find longest prefix in at most max_levels levels starting from
+             * node, high and low are remaining bits of address.
+             */
+            const T* descend(const node& start, uint64_t high, uint64_t low, unsigned max_levels) const noexcept {
+                const node* current = &start;
+                const node* best_node = nullptr;
+                unsigned best_position = 0;
+                for (unsigned level = 0; level < max_levels; ++level) {
+                    auto chunk_value = unsigned(high >> (64u - trie_stride));
+                    high = (high << trie_stride) | (low >> (64u - trie_stride));
+                    low <<= trie_stride;
+
+                    uint64_t match = current->internal & prefix_match_masks[chunk_value];
+                    if (match != 0) {
+                        // Longer prefixes have higher positions.
+                        best_node = current;
+                        best_position = highest_bit(match);
+                    }
+                    if ((current->external >> chunk_value & 1u) == 0) break;
+                    current = &nodes[current->children
+                                     + popcount(current->external & ((uint64_t(1) << chunk_value) - 1))];
+                }
+
+                if (best_node == nullptr) return nullptr;
+                return &values[best_node->results
+                               + popcount(best_node->internal & ((uint64_t(1) << best_position) - 1))];
+            }
+
+            /**
+             * Update direct table entries pointing to children of node with
+             * index, which is parent of nodes referenced by direct table.
+             */
+            void update_direct(uint32_t index, const uint8_t* bytes) noexcept {
+                const node& parent = nodes[index];
+                size_t first = size_t(load_big_endian(bytes) >> (64u - trie_direct_bits)) & ~size_t((1u << trie_stride) - 1);
+                for (unsigned chunk_value = 0; chunk_value < (1u << trie_stride); ++chunk_value) {
+                    uint64_t bit = uint64_t(1) << chunk_value;
+                    direct[first + chunk_value] =
+                        (parent.external & bit) != 0 ? parent.children + popcount(parent.external & (bit - 1)) : 0;
+                }
+            }
+
+            /**
+             * Get trie_stride bits of address starting from offset, bits
+             * after end of address are zeros.
+             */
+            static unsigned chunk(const uint8_t* bytes, unsigned offset) noexcept {
+                size_t byte = offset / 8u;
+                unsigned word = unsigned(bytes[byte]) << 8u;
+                if (byte + 1 < 16) word |= bytes[byte + 1];
+                return (word >> (16u - trie_stride - offset % 8u)) & ((1u << trie_stride) - 1);
+            }
+
+            static uint64_t load_big_endian(const uint8_t* bytes) noexcept {
+                uint64_t result = 0;
+                for (size_t i = 0; i < 8; ++i) result = result << 8u | bytes[i];
+                return result;
+            }
+
+            static unsigned prefix_position(const uint8_t* bytes, unsigned offset, unsigned length) noexcept {
+                unsigned bits = length == 0 ? 0 : chunk(bytes, offset) >> (trie_stride - length);
+                return (1u << length) - 1 + bits;
+            }
+
+            uint32_t make_child(uint32_t index, unsigned chunk_value, const uint8_t* bytes, unsigned offset) {
+                node current = nodes[index];
+                uint64_t bit = uint64_t(1) << chunk_value;
+                unsigned rank = popcount(current.external & (bit - 1));
+                if ((current.external & bit) != 0) return current.children + rank;
+
+                unsigned count = popcount(current.external);
+                uint32_t block = nodes.allocate(count + 1);
+                for (unsigned i = 0; i < rank; ++i) nodes[block + i] = nodes[current.children + i];
+                nodes[block + rank] = node();
+                for (unsigned i = rank; i < count; ++i) nodes[block + i + 1] = nodes[current.children + i];
+                if (count != 0) nodes.release(current.children, count);
+
+                nodes[index].children = block;
+                nodes[index].external |= bit;
+                if (offset == trie_direct_bits - trie_stride) update_direct(index, bytes);
+                return block + rank;
+            }
+
+            void remove_child(uint32_t index, unsigned chunk_value, const uint8_t* bytes, unsigned offset) {
+                node current = nodes[index];
+                uint64_t bit = uint64_t(1) << chunk_value;
+                unsigned rank = popcount(current.external & (bit - 1));
+                unsigned count = popcount(current.external);
+
+                uint32_t block = 0;
+                if (count > 1) {
+                    block = nodes.allocate(count - 1);
+                    for (unsigned i = 0; i < rank; ++i) nodes[block + i] = nodes[current.children + i];
+                    for (unsigned i = rank + 1; i < count; ++i) nodes[block + i - 1] = nodes[current.children + i];
+                }
+                nodes.release(current.children, count);
+
+                nodes[index].children = block;
+                nodes[index].external &= ~bit;
+                if (offset == trie_direct_bits - trie_stride) update_direct(index, bytes);
+            }
+
+            block_pool<node> nodes;
+            block_pool<T> values;
+            std::vector<uint32_t> direct;
+        };
+    } // namespace internal_
+
+    /**
+     * Table of IPv4 and IPv6 network prefixes with associated values,
+     * answers which most specific (longest) prefix contains address.
+     *
+     * Intended for admission control and routing decisions, for example:
+     * \code
+     * prefix_table<bool> allowed;
+     * allowed.insert_or_assign(cidr("10.0.0.0/8"), true);
+     * allowed.insert_or_assign(cidr("10.66.0.0/16"), false);
+     *
+     * auto sock = listener.accept();
+     * const bool* allow = allowed.lookup(sock.remote_endpoint().addr);
+     * if (allow == nullptr || !*allow) sock.close();
+     * \endcode
+     *
+     * Lookup resolves first 12 bits of address using direct table and
+     * then visits one trie node per 6 bits of longest matching prefix
+     * (at most 4 nodes for IPv4, 20 for IPv6), it doesn't allocate
+     * memory. Updates are local to one path of trie but may allocate.
+     *
+     * IPv4-mapped IPv6 addresses (::ffff:a.b.c.d, reported for IPv4
+     * clients of dual-stack sockets) are looked up in IPv4 prefixes.
+     *
+     * T should be default constructible and move assignable.
+     */
+    template<typename T>
+    class prefix_table {
+    public:
+        using mapped_type = T;
+        using size_type = size_t;
+
+        /**
+         * Set value for prefix, returns true if prefix was not
+         * present in table before.
+         */
+        template<typename V>
+        bool insert_or_assign(const cidr& prefix, V&& value) {
+            assert(!prefix.is_invalid());
+            bool inserted = trie(prefix.addr.version)
+                                .insert_or_assign(prefix.addr.parts.data(), prefix.prefix_length, std::forward<V>(value));
+            if (inserted) ++elements;
+            return inserted;
+        }
+
+        /**
+         * Remove prefix, returns true if it was present in table.
+         */
+        bool erase(const cidr& prefix) {
+            assert(!prefix.is_invalid());
+            bool erased = trie(prefix.addr.version).erase(prefix.addr.parts.data(), prefix.prefix_length);
+            if (erased) --elements;
+            return erased;
+        }
+
+        /**
+         * Get value of exactly this prefix, nullptr if it is not
+         * present in table.
+         */
+        const T* find(const cidr& prefix) const noexcept {
+            if (prefix.is_invalid()) return nullptr;
+            return trie(prefix.addr.version).find(prefix.addr.parts.data(), prefix.prefix_length);
+        }
+
+        T* find(const cidr& prefix) noexcept {
+            return const_cast<T*>(static_cast<const prefix_table*>(this)->find(prefix));
+        }
+
+        /**
+         * Get value of longest prefix containing address, nullptr if
+         * there is no such prefix.
+         */
+        const T* lookup(const address& addr) const noexcept {
+            if (addr.version == ip::v4) return ipv4.lookup(addr.parts.data());
+            if (addr.version != ip::v6) return nullptr;
+
+            static constexpr std::array<uint8_t, 12> mapped_prefix = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+            if (std::equal(mapped_prefix.begin(), mapped_prefix.end(), addr.parts.begin())) {
+                std::array<uint8_t, 16> ipv4_parts{addr.parts[12], addr.parts[13], addr.parts[14], addr.parts[15]};
+                return ipv4.lookup(ipv4_parts.data());
+            }
+            return ipv6.lookup(addr.parts.data());
+        }
+
+        bool empty() const noexcept {
+            return elements == 0;
+        }
+
+        size_type size() const noexcept {
+            return elements;
+        }
+
+        void clear() {
+            ipv4.clear();
+            ipv6.clear();
+            elements = 0;
+        }
+
+    private:
+        internal_::tree_bitmap<T>& trie(ip version) noexcept {
+            return version == ip::v4 ? ipv4 : ipv6;
+        }
+
+        const internal_::tree_bitmap<T>& trie(ip version) const noexcept {
+            return version == ip::v4 ? ipv4 : ipv6;
+        }
+
+        internal_::tree_bitmap<T> ipv4;
+        internal_::tree_bitmap<T> ipv6;
+        size_type elements = 0;
+    };
+} // namespace libwire
@@ -0,0 +1,285 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <vector>
+#include <libwire/endpoint.hpp>
+#include <libwire/tcp/listener.hpp>
+#include <libwire/tcp/socket.hpp>
+#include <libwire/udp/socket.hpp>
+#include <libwire/internal/bsdsocket.hpp>
+#include <libwire/internal/platform.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file proactor.hpp
+ *
+ * This file defines proactor type, completion-based I/O loop.
+ *
+ * \note Currently available only on Linux 5.6+ (implemented using io_uring).
+ * Building it requires kernel headers from Linux 5.11+, LIBWIRE_IO_URING is
+ * defined if they are present.
+ */
+
+#if defined(LIBWIRE_LINUX) && defined(LIBWIRE_IO_URING)
+
+struct io_uring_sqe;
+
+namespace libwire {
+    /**
+     * Completion-based I/O loop.
+     *
+     * As opposed to \ref reactor, which notifies when socket is *ready* for
+     * I/O, proactor performs I/O itself and notifies when operation is
+     * *completed*. Operations started by async_* functions are queued and
+     * submitted to kernel in one batch by next \ref run_once call which
+     * also collects completions, so there is one system call per loop
+     * iteration instead of one per operation.
+     *
+     * Quick usage example:
+     * \code
+     * proactor p;
+     * std::vector<uint8_t> buf(4096);
+     * p.async_read(sock, buf, [&](size_t bytes, const std::error_code& ec) {
+     *     if (ec) return;
+     *     // buf[0; bytes) contains received data.
+     * });
+     * p.run();
+     * \endcode
+     *
+     * Sockets and buffers passed to async_* functions should remain valid
+     * until handler is called. Handlers are called only from \ref run_once
+     * and \ref run, never from async_* functions themselves. Errors are
+     * always delivered to handler.
+     *
+     * ##### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe
+     */
+    class proactor {
+    public:
+        /**
+         * Default count of submission queue entries.
+         */
+        static constexpr unsigned default_queue_depth = 256;
+
+        using io_handler_t = std::function<void(size_t bytes, const std::error_code&)>;
+        using accept_handler_t = std::function<void(tcp::socket&&, const std::error_code&)>;
+        using connect_handler_t = std::function<void(const std::error_code&)>;
+        using read_from_handler_t =
+            std::function<void(size_t bytes, const endpoint& source, const std::error_code&)>;
+
+        /**
+         * Create io_uring instance with queue_depth entries in submission
+         * queue, set ec if it's not supported by system or limit reached.
+         *
+         * queue_depth is not a limit for count of operations in flight,
+         * proactor will flush submission queue early if it's full.
+         */
+        explicit proactor(std::error_code& ec, unsigned queue_depth = default_queue_depth) noexcept;
+
+        proactor(const proactor&) = delete;
+        proactor(proactor&&) = delete;
+        proactor& operator=(const proactor&) = delete;
+        proactor& operator=(proactor&&) = delete;
+
+        /**
+         * Cancel operations in flight and destroy ring. Waits until kernel
+         * releases their buffers, handlers will not be called.
+         */
+        ~proactor();
+
+        /**
+         * Accept connection from listener's queue, accepted socket
+         * remembers peer endpoint (see \ref tcp::socket::remote_endpoint).
+         */
+        void async_accept(tcp::listener& listener, accept_handler_t handler);
+
+        /**
+         * Allocate new socket and connect it to target.
+         *
+         * sock is replaced by new socket immediately, but it can
+         * be used only after handler is called without error.
+         */
+        void async_connect(tcp::socket& sock, endpoint target, connect_handler_t handler);
+
+        /**
+         * Read up to buffer.size() bytes from socket (recv), bytes count
+         * is passed to handler.
+         *
+         * Zero bytes received while buffer is not empty is reported as
+         * error::end_of_file.
+         */
+        template<typename Socket, typename Buffer>
+        void async_read(Socket& sock, Buffer& buffer, io_handler_t handler) {
+            static_assert(sizeof(std::remove_pointer_t<decltype(buffer.data())>) == sizeof(uint8_t),
+                          "proactor::async_read can't be used with container with non-byte elements");
+            read_impl(sock.native_handle(), buffer.data(), buffer.size(), std::move(handler));
+        }
+
+        /**
+         * Write contents of buffer to socket (send), bytes count written is
+         * passed to handler.
+         */
+        template<typename Socket, typename Buffer>
+        void async_write(Socket& sock, const Buffer& buffer, io_handler_t handler) {
+            static_assert(sizeof(std::remove_pointer_t<decltype(buffer.data())>) == sizeof(uint8_t),
+                          "proactor::async_write can't be used with container with non-byte elements");
+            write_impl(sock.native_handle(), buffer.data(), buffer.size(), std::move(handler));
+        }
+
+        /**
+         * Receive datagram (recvmsg) and its source endpoint.
+         *
+         * If datagram is larger than buffer it will be truncated.
+         */
+        template<typename Buffer>
+        void async_read_from(udp::socket& sock, Buffer& buffer, read_from_handler_t handler) {
+            static_assert(sizeof(std::remove_pointer_t<decltype(buffer.data())>) == sizeof(uint8_t),
+                          "proactor::async_read_from can't be used with container with non-byte elements");
+            read_from_impl(sock.native_handle(), buffer.data(), buffer.size(), std::move(handler));
+        }
+
+        /**
+         * Send datagram (sendmsg) to specified destination.
+         */
+        template<typename Buffer>
+        void async_write_to(udp::socket& sock, const Buffer& buffer, const endpoint& dest, io_handler_t handler) {
+            static_assert(sizeof(std::remove_pointer_t<decltype(buffer.data())>) == sizeof(uint8_t),
+                          "proactor::async_write_to can't be used with container with non-byte elements");
+            write_to_impl(sock.native_handle(), buffer.data(), buffer.size(), dest, std::move(handler));
+        }
+
+        /**
+         * Count of operations started but not completed yet.
+         */
+        size_t pending() const noexcept;
+
+        /**
+         * Submit queued operations and wait at most timeout for at least
+         * one completion, then call handlers of all completed operations.
+         *
+         * Negative timeout means "wait forever", zero means "don't wait".
+         *
+         * Returns count of handlers called.
+         *
+         * \note Positive timeouts require Linux 5.11+, older kernels will
+         * wait forever.
+         */
+        size_t run_once(std::chrono::milliseconds timeout, std::error_code& ec) noexcept;
+
+        /**
+         * Dispatch completions until there are no pending operations left or
+         * error occurred.
+         */
+        void run(std::error_code& ec) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        explicit proactor(unsigned queue_depth = default_queue_depth);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t run_once(std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void run();
+#endif // ifdef __cpp_exceptions
+
+    private:
+        // Both defined in implementation file to avoid inclusion of
+        // system headers here.
+        struct uring;
+        struct operation;
+
+        void init(unsigned queue_depth, std::error_code&) noexcept;
+
+        operation* allocate_operation();
+        void release_operation(operation*) noexcept;
+
+        /**
+         * Get next submission queue entry for op, flushing queue if
+         * it's full. Returns nullptr (and fails operation) if no entry
+         * is available even after flush.
+         */
+        io_uring_sqe* next_sqe(operation* op) noexcept;
+
+        /**
+         * Queue operation that failed before submission, its handler
+         * will be called by next run_once.
+         */
+        void fail(operation*, int error) noexcept;
+
+        /**
+         * Submit all queued entries, if min_complete is not zero - wait
+         * until this count of operations is completed.
+         */
+        void enter(unsigned min_complete, std::chrono::milliseconds timeout, std::error_code& ec) noexcept;
+
+        /**
+         * Cancel all submitted operations and wait for their completions
+         * without calling handlers.
+         */
+        void cancel_all() noexcept;
+
+        void read_impl(internal_::socket::native_handle_t, void*, size_t, io_handler_t&&);
+        void write_impl(internal_::socket::native_handle_t, const void*, size_t, io_handler_t&&);
+        void read_from_impl(internal_::socket::native_handle_t, void*, size_t, read_from_handler_t&&);
+        void write_to_impl(internal_::socket::native_handle_t, const void*, size_t, const endpoint&,
+                           io_handler_t&&);
+
+        std::unique_ptr<uring> ring;
+
+        // All operations ever allocated, reused through free_operations.
+        std::vector<std::unique_ptr<operation>> operations;
+        std::vector<operation*> free_operations;
+
+        // Operations failed before submission.
+        std::vector<std::pair<operation*, int>> failed;
+
+        // Scratch space for run_once, kept here to avoid reallocation.
+        std::vector<std::pair<operation*, int>> completed;
+
+        size_t in_flight = 0;
+    };
+} // namespace libwire
+
+#endif // if defined(LIBWIRE_LINUX) && defined(LIBWIRE_IO_URING)
@@ -0,0 +1,268 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include <libwire/options.hpp>
+#include <libwire/internal/bsdsocket.hpp>
+#include <libwire/internal/platform.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file reactor.hpp
+ *
+ * This file defines reactor type, readiness notification loop for
+ * non-blocking sockets.
+ *
+ * \note Currently available only on Linux (implemented using epoll).
+ */
+
+#if defined(LIBWIRE_LINUX)
+
+namespace libwire {
+    /**
+     * Readiness notification loop for non-blocking sockets.
+     *
+     * Sockets (\ref tcp::socket, \ref tcp::listener, \ref udp::socket) are
+     * registered together with handler function. Reactor switches them into
+     * non-blocking mode and calls handler each time socket becomes ready for
+     * requested operations, so one thread can serve many connections.
+     *
+     * Notifications are **edge-triggered**: handler is called only when
+     * readiness state changes, so it should perform I/O until operation fails
+     * with error::would_block, otherwise next notification may never arrive.
+     *
+     * Quick usage example:
+     * \code
+     * reactor r;
+     * tcp::listener l{{ipv4::any, 7777}};
+     * r.add(l, reactor::readable, [&](unsigned) {
+     *     std::error_code ec;
+     *     while (true) {
+     *         auto sock = l.accept(ec);
+     *         if (ec) break;
+     *         // register sock in reactor...
+     *     }
+     * });
+     * r.run();
+     * \endcode
+     *
+     * Reactor doesn't owns registered sockets, socket must be removed from
+     * reactor (or reactor destroyed) before socket is closed.
+     *
+     * ##### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe, except \ref stop which can be called from any thread.
+     */
+    class reactor {
+    public:
+        /**
+         * Bit flags for events passed to \ref add and received by handler.
+         */
+        enum event : unsigned {
+            /**
+             * Data (or pending connection for listener) is available for reading.
+             */
+            readable = 1u << 0u,
+
+            /**
+             * Socket have space in send buffer (or connection is established
+             * after non-blocking connect).
+             */
+            writable = 1u << 1u,
+
+            /**
+             * Error is pending on socket. Always reported, no need to request it.
+             */
+            error = 1u << 2u,
+
+            /**
+             * Connection is closed by remote side. Always reported, no need to
+             * request it.
+             */
+            hangup = 1u << 3u,
+        };
+
+        /**
+         * Handler function type, receives bit mask of \ref event values.
+         */
+        using handler_t = std::function<void(unsigned events)>;
+
+        /**
+         * Create reactor, set ec if system refused to allocate
+         * epoll instance.
+         */
+        explicit reactor(std::error_code& ec) noexcept;
+
+        reactor(const reactor&) = delete;
+        reactor(reactor&&) = delete;
+        reactor& operator=(const reactor&) = delete;
+        reactor& operator=(reactor&&) = delete;
+
+        ~reactor();
+
+        /**
+         * Register socket in reactor and switch it into non-blocking mode
+         * (no-op for sockets created non-blocking, such as ones accepted
+         * with \ref tcp::listener::set_accept_non_blocking).
+         *
+         * handler will be called from \ref run_once or \ref run each time
+         * when any of events passed in events mask is triggered.
+         *
+         * Registering same socket twice is not allowed, use \ref modify
+         * to change mask or handler.
+         */
+        template<typename Socket>
+        void add(Socket& sock, unsigned events, handler_t handler, std::error_code& ec) noexcept {
+            if (!sock.implementation().state.user_non_blocking) non_blocking_t::set(sock, true);
+            add_impl(sock.native_handle(), events, std::move(handler), ec);
+        }
+
+        /**
+         * Change events mask for already registered socket.
+         */
+        template<typename Socket>
+        void modify(Socket& sock, unsigned events, std::error_code& ec) noexcept {
+            modify_impl(sock.native_handle(), events, ec);
+        }
+
+        /**
+         * Stop watching socket. Handler object will be destroyed after
+         * current dispatch round (so it's safe to call remove from handler).
+         *
+         * Have no effect if socket is not registered.
+         */
+        template<typename Socket>
+        void remove(Socket& sock) noexcept {
+            remove_impl(sock.native_handle());
+        }
+
+        /**
+         * Count of registered sockets.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * Wait for events at most timeout and dispatch them to handlers.
+         * Negative timeout means "wait forever".
+         *
+         * Returns count of handlers called.
+         */
+        size_t run_once(std::chrono::milliseconds timeout, std::error_code& ec) noexcept;
+
+        /**
+         * Dispatch events until \ref stop is called or error occurred.
+         */
+        void run(std::error_code& ec) noexcept;
+
+        /**
+         * Make \ref run return after current dispatch round. If run is not
+         * running, next call to it returns immediately.
+         *
+         * Can be called from other thread or from handler.
+         */
+        void stop() noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        reactor();
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Socket>
+        void add(Socket& sock, unsigned events, handler_t handler) {
+            std::error_code ec;
+            add(sock, events, std::move(handler), ec);
+            if (ec) throw std::system_error(ec);
+        }
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Socket>
+        void modify(Socket& sock, unsigned events) {
+            std::error_code ec;
+            modify(sock, events, ec);
+            if (ec) throw std::system_error(ec);
+        }
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t run_once(std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void run();
+#endif // ifdef __cpp_exceptions
+
+    private:
+        struct registration {
+            internal_::socket::native_handle_t handle;
+            handler_t handler;
+        };
+
+        void init(std::error_code&) noexcept;
+
+        void add_impl(internal_::socket::native_handle_t, unsigned events, handler_t&&, std::error_code&) noexcept;
+        void modify_impl(internal_::socket::native_handle_t, unsigned events, std::error_code&) noexcept;
+        void remove_impl(internal_::socket::native_handle_t) noexcept;
+
+        internal_::socket::native_handle_t epoll_handle = internal_::socket::not_initialized;
+
+        // eventfd used to wake up run() from stop().
+        internal_::socket::native_handle_t wakeup_handle = internal_::socket::not_initialized;
+
+        std::unordered_map<internal_::socket::native_handle_t, std::unique_ptr<registration>> registrations;
+
+        // Removed registrations, kept alive until end of dispatch round
+        // because epoll may still return pointers to them. Capacity is
+        // reserved by add_impl.
+        std::vector<std::unique_ptr<registration>> removed;
+
+        std::atomic<bool> stopped{false};
+    };
+} // namespace libwire
+
+#endif // if defined(LIBWIRE_LINUX)
@@ -5,5 +5,8 @@
 namespace libwire::tcp {} // namespace libwire::tcp
 
 #include "tcp/listener.hpp"
+#include "tcp/listener_group.hpp"
 #include "tcp/socket.hpp"
+#include "tcp/buffered_socket.hpp"
+#include "tcp/forward.hpp"
 #include "tcp/options.hpp"
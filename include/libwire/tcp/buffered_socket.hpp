@@ -0,0 +1,441 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <system_error>
+#include <vector>
+#include <libwire/tcp/socket.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file tcp/buffered_socket.hpp
+ *
+ * This file defines tcp::buffered_socket type, wrapper for tcp::socket
+ * with user-space receive buffer.
+ */
+
+namespace libwire::tcp {
+    /**
+     * TCP socket with user-space receive buffer.
+     *
+     * Plain \ref socket::read_until have to request data from system
+     * byte-by-byte because it can't "give back" bytes received after
+     * delimiter. buffered_socket keeps such bytes in own buffer and
+     * serves following reads from it, so system is asked for more data
+     * only when buffer is drained.
+     *
+     * Writes are passed to underlying socket as is.
+     *
+     * Quick usage example:
+     * \code
+     * tcp::buffered_socket sock{listener.accept()};
+     * auto line = sock.read_until<std::string>('\n');
+     * \endcode
+     *
+     * \warning Don't read from underlying socket (\ref next_layer) directly
+     * because data already buffered will be lost for it.
+     *
+     * ##### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe
+     */
+    class buffered_socket {
+    public:
+        /**
+         * Default size of receive buffer, in bytes.
+         */
+        static constexpr size_t default_buffer_size = 8 * 1024;
+
+        /**
+         * Create buffered_socket with not connected underlying socket.
+         */
+        buffered_socket() = default;
+
+        /**
+         * Take ownership of socket and allocate receive buffer of
+         * buffer_size bytes for it.
+         */
+        explicit buffered_socket(socket&& sock, size_t buffer_size = default_buffer_size);
+
+        buffered_socket(const buffered_socket&) = delete;
+        buffered_socket(buffered_socket&&) noexcept = default;
+
+        buffered_socket& operator=(const buffered_socket&) = delete;
+        buffered_socket& operator=(buffered_socket&&) noexcept = default;
+
+        ~buffered_socket() = default;
+
+        /**
+         * Get reference to underlying socket.
+         *
+         * Can be used to set options, get endpoints, etc.
+         */
+        socket& next_layer() noexcept;
+        const socket& next_layer() const noexcept;
+
+        /**
+         * Count of bytes received from system but not consumed
+         * by any read function yet.
+         */
+        size_t buffered() const noexcept;
+
+        /**
+         * Same as \ref socket::connect, also discards buffered data.
+         */
+        void connect(endpoint target, std::error_code& ec) noexcept;
+
+        /**
+         * Same as \ref socket::close, also discards buffered data.
+         */
+        void close() noexcept;
+
+        /**
+         * \name Blocking I/O
+         *
+         * I/O functions in this category usually block thread until
+         * operation is completed.
+         */
+        ///@{
+
+        /**
+         * Read **up to** bytes_count bytes into buffer passed by reference.
+         * Buffer will be resized to actual count of bytes received.
+         *
+         * If there is any buffered data then it will be returned without
+         * touching socket. Otherwise at most one system call will be made.
+         *
+         * **Buffer type requirements:**
+         *
+         * Buffer must be container that encapsulates dynamic array,
+         * so it must have data, size and resize member functions with
+         * behavior as in std::vector.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, std::error_code&) noexcept;
+
+        /**
+         * Same as overload with Buffer argument but return newly allocated
+         * buffer every time.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read(size_t bytes_count, std::error_code&) noexcept;
+
+        /**
+         * Read exactly bytes_count bytes into buffer passed by reference,
+         * same as \ref socket::read.
+         *
+         * Large reads bypass receive buffer once it's drained.
+         *
+         * Buffer will be resized to count of bytes received before error
+         * if any.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read_exactly(size_t bytes_count, Buffer&, std::error_code&) noexcept;
+
+        /**
+         * Same as overload with Buffer argument but return newly allocated
+         * buffer every time.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read_exactly(size_t bytes_count, std::error_code&) noexcept;
+
+        /**
+         * Read from socket until until gives byte is found or max_size
+         * bytes read, same as \ref socket::read_until.
+         *
+         * \note Delimiter will be removed from socket stream but will
+         * not be appended to buffer.
+         *
+         * \note max_size = 0 is a special case and means "no limit".
+         * If limit is reached then byte following last read byte stays
+         * in stream.
+         *
+         * **Buffer Type Requirements**
+         *
+         * size(), clear() and insert(end, first, last) functions with behavior
+         * defined in SequenceContainer concept.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read_until(uint8_t delimiter, Buffer& buf, std::error_code&, size_t max_size = 0) noexcept;
+
+        /**
+         * Same as overload with buffer argument but returns newly
+         * allocated buffer every time.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read_until(uint8_t delimiter, std::error_code&, size_t max_size = 0) noexcept;
+
+        /**
+         * Write contents of buffer to underlying socket, same as
+         * \ref socket::write.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, std::error_code&) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void connect(endpoint target);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&);
+
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read(size_t bytes_count);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read_exactly(size_t bytes_count, Buffer&);
+
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read_exactly(size_t bytes_count);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read_until(uint8_t delimiter, Buffer& buf, size_t max_size = 0);
+
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer read_until(uint8_t delimiter, size_t max_size = 0);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&);
+#endif // ifdef __cpp_exceptions
+
+        ///@}
+    private:
+        /**
+         * Copy up to length_bytes into output, serving from receive buffer
+         * if it's not empty. Otherwise read directly into output (if
+         * request is not smaller than buffer) or refill buffer first.
+         */
+        size_t read_some(void* output, size_t length_bytes, std::error_code& ec) noexcept;
+
+        /**
+         * Refill drained receive buffer using one read call.
+         */
+        size_t fill(std::error_code& ec) noexcept;
+
+        socket sock;
+        std::vector<uint8_t> buffer;
+
+        // Unconsumed data is buffer[begin; end).
+        size_t begin = 0, end = 0;
+    };
+
+    template<typename Buffer>
+    Buffer& buffered_socket::read(size_t bytes_count, Buffer& output, std::error_code& ec) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(output.data())>) == sizeof(uint8_t),
+                      "buffered_socket::read can't be used with container with non-byte elements");
+
+        output.resize(bytes_count);
+        size_t received = read_some(output.data(), bytes_count, ec);
+        output.resize(received);
+        return output;
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read(size_t bytes_count, std::error_code& ec) noexcept {
+        Buffer buffer{};
+        return read(bytes_count, buffer, ec);
+    }
+
+    extern template std::vector<uint8_t> buffered_socket::read(size_t, std::error_code&);
+    extern template std::string buffered_socket::read(size_t, std::error_code&);
+
+    extern template std::vector<uint8_t>& buffered_socket::read(size_t, std::vector<uint8_t>&, std::error_code&);
+    extern template std::string& buffered_socket::read(size_t, std::string&, std::error_code&);
+
+    template<typename Buffer>
+    Buffer& buffered_socket::read_exactly(size_t bytes_count, Buffer& output, std::error_code& ec) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(output.data())>) == sizeof(uint8_t),
+                      "buffered_socket::read_exactly can't be used with container with non-byte elements");
+
+        output.resize(bytes_count);
+        size_t total_received = 0;
+        while (total_received < bytes_count) {
+            total_received += read_some(output.data() + total_received, bytes_count - total_received, ec);
+            if (ec) break;
+        }
+        output.resize(total_received);
+        return output;
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read_exactly(size_t bytes_count, std::error_code& ec) noexcept {
+        Buffer buffer{};
+        return read_exactly(bytes_count, buffer, ec);
+    }
+
+    extern template std::vector<uint8_t> buffered_socket::read_exactly(size_t, std::error_code&);
+    extern template std::string buffered_socket::read_exactly(size_t, std::error_code&);
+
+    extern template std::vector<uint8_t>& buffered_socket::read_exactly(size_t, std::vector<uint8_t>&,
+                                                                        std::error_code&);
+    extern template std::string& buffered_socket::read_exactly(size_t, std::string&, std::error_code&);
+
+    template<typename Buffer>
+    Buffer& buffered_socket::read_until(uint8_t delimiter, Buffer& buf, std::error_code& ec,
+                                        size_t max_size) noexcept {
+        buf.clear();
+        while (true) {
+            if (begin == end) {
+                fill(ec);
+                if (ec) return buf;
+            }
+
+            size_t available = end - begin;
+            if (max_size != 0) available = std::min(available, max_size - buf.size());
+
+            const uint8_t* first = buffer.data() + begin;
+            const auto* found = static_cast<const uint8_t*>(std::memchr(first, delimiter, available));
+            if (found != nullptr) {
+                buf.insert(buf.end(), first, found);
+                begin += size_t(found - first) + 1; // Consume delimiter too.
+                return buf;
+            }
+
+            buf.insert(buf.end(), first, first + available);
+            begin += available;
+            if (max_size != 0 && buf.size() == max_size) return buf;
+        }
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read_until(uint8_t delimiter, std::error_code& ec, size_t max_size) noexcept {
+        Buffer buffer{};
+        read_until(delimiter, buffer, ec, max_size);
+        return buffer;
+    }
+
+    extern template std::vector<uint8_t> buffered_socket::read_until(uint8_t, std::error_code&, size_t);
+    extern template std::string buffered_socket::read_until(uint8_t, std::error_code&, size_t);
+
+    extern template std::vector<uint8_t>& buffered_socket::read_until(uint8_t, std::vector<uint8_t>&,
+                                                                      std::error_code&, size_t);
+    extern template std::string& buffered_socket::read_until(uint8_t, std::string&, std::error_code&, size_t);
+
+    template<typename Buffer>
+    size_t buffered_socket::write(const Buffer& input, std::error_code& ec) noexcept {
+        return sock.write(input, ec);
+    }
+
+    extern template size_t buffered_socket::write(const std::vector<uint8_t>&, std::error_code&);
+    extern template size_t buffered_socket::write(const std::string&, std::error_code&);
+
+#ifdef __cpp_exceptions
+    template<typename Buffer>
+    Buffer& buffered_socket::read(size_t bytes_count, Buffer& output) {
+        std::error_code ec;
+        read<Buffer>(bytes_count, output, ec);
+        if (ec) throw std::system_error(ec);
+        return output;
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read(size_t bytes_count) {
+        Buffer buffer{};
+        return read(bytes_count, buffer);
+    }
+
+    extern template std::vector<uint8_t>& buffered_socket::read(size_t, std::vector<uint8_t>&);
+    extern template std::string& buffered_socket::read(size_t, std::string&);
+
+    extern template std::vector<uint8_t> buffered_socket::read(size_t);
+    extern template std::string buffered_socket::read(size_t);
+
+    template<typename Buffer>
+    Buffer& buffered_socket::read_exactly(size_t bytes_count, Buffer& output) {
+        std::error_code ec;
+        read_exactly<Buffer>(bytes_count, output, ec);
+        if (ec) throw std::system_error(ec);
+        return output;
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read_exactly(size_t bytes_count) {
+        Buffer buffer{};
+        return read_exactly(bytes_count, buffer);
+    }
+
+    extern template std::vector<uint8_t>& buffered_socket::read_exactly(size_t, std::vector<uint8_t>&);
+    extern template std::string& buffered_socket::read_exactly(size_t, std::string&);
+
+    extern template std::vector<uint8_t> buffered_socket::read_exactly(size_t);
+    extern template std::string buffered_socket::read_exactly(size_t);
+
+    template<typename Buffer>
+    Buffer& buffered_socket::read_until(uint8_t delimiter, Buffer& buf, size_t max_size) {
+        std::error_code ec;
+        read_until<Buffer>(delimiter, buf, ec, max_size);
+        if (ec) throw std::system_error(ec);
+        return buf;
+    }
+
+    template<typename Buffer>
+    Buffer buffered_socket::read_until(uint8_t delimiter, size_t max_size) {
+        Buffer buffer{};
+        return read_until(delimiter, buffer, max_size);
+    }
+
+    extern template std::vector<uint8_t>& buffered_socket::read_until(uint8_t, std::vector<uint8_t>&, size_t);
+    extern template std::string& buffered_socket::read_until(uint8_t, std::string&, size_t);
+
+    extern template std::vector<uint8_t> buffered_socket::read_until(uint8_t, size_t);
+    extern template std::string buffered_socket::read_until(uint8_t, size_t);
+
+    template<typename Buffer>
+    size_t buffered_socket::write(const Buffer& input) {
+        std::error_code ec;
+        size_t res = write<Buffer>(input, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t buffered_socket::write(const std::vector<uint8_t>&);
+    extern template size_t buffered_socket::write(const std::string&);
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::tcp
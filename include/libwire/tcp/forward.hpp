@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+#include <libwire/internal/platform.hpp>
+#include <libwire/tcp/socket.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file tcp/forward.hpp
+ *
+ * This file defines tcp::forward function, used to relay stream from one
+ * TCP connection to another without copying it to user space.
+ */
+
+namespace libwire::tcp {
+    /**
+     * Result of \ref forward call.
+     */
+    struct forward_result {
+        /**
+         * Count of bytes written to destination socket.
+         */
+        uint64_t bytes = 0;
+
+        /**
+         * Set if source socket reached end of stream and all data
+         * received from it is written to destination. Write part of
+         * destination connection is shut down in this case, so peer
+         * receives end of stream too.
+         */
+        bool half_closed = false;
+    };
+
+    /**
+     * Intermediate buffer used by \ref forward to keep data already
+     * received from source socket but not written to destination yet.
+     *
+     * On Linux it's a pipe: data is moved between sockets and pipe using
+     * splice(), so it never leaves kernel. On other platforms it's plain
+     * user-space buffer.
+     *
+     * Buffer is allocated lazily by first \ref forward call. Each direction
+     * of relayed connection needs own buffer.
+     *
+     * ##### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe
+     */
+    class forward_buffer {
+    public:
+        /**
+         * Default capacity of buffer, in bytes.
+         */
+        static constexpr size_t default_capacity = 256 * 1024;
+
+        /**
+         * Create buffer with specified capacity in bytes.
+         *
+         * Capacity is a hint: on Linux it's rounded by kernel to page size
+         * and limited by /proc/sys/fs/pipe-max-size for unprivileged
+         * processes.
+         */
+        explicit forward_buffer(size_t capacity = default_capacity) noexcept;
+
+        forward_buffer(const forward_buffer&) = delete;
+        forward_buffer(forward_buffer&&) noexcept;
+
+        forward_buffer& operator=(const forward_buffer&) = delete;
+        forward_buffer& operator=(forward_buffer&&) noexcept;
+
+        ~forward_buffer();
+
+        /**
+         * Count of bytes received from source socket but not written
+         * to destination yet.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * Check whether there is no pending data.
+         */
+        bool empty() const noexcept;
+
+    private:
+        friend forward_result forward(socket& from, socket& to, forward_buffer& buffer, std::error_code& ec,
+                                      uint64_t max_bytes) noexcept;
+
+        size_t capacity;
+        size_t pending = 0;
+#if defined(LIBWIRE_LINUX)
+        int pipe_read = -1, pipe_write = -1;
+#else
+        std::vector<uint8_t> data;
+        size_t first = 0;
+#endif
+    };
+
+    /**
+     * Relay data received from one socket to another.
+     *
+     * On Linux data is moved using splice() through pipe in buffer so it's
+     * never copied to user space, elsewhere it's read into buffer and then
+     * written.
+     *
+     * Works with both blocking and non-blocking sockets:
+     * * If both sockets are blocking then function returns only when source
+     *   connection is half-closed by peer, error occurred or max_bytes are
+     *   written.
+     * * If socket is in non-blocking mode and operation can't make any
+     *   progress then error::would_block is reported. Wait until source is
+     *   readable (if buffer is empty) or destination is writable (if it's
+     *   not) and call forward again with same buffer.
+     *
+     * max_bytes limits count of bytes written by one call, it can be used
+     * to relay many connections fairly from one thread.
+     *
+     * Relaying TCP connection in both directions using two threads:
+     * \code
+     * std::thread([&]() {
+     *     tcp::forward_buffer buffer;
+     *     std::error_code ec;
+     *     tcp::forward(client, upstream, buffer, ec);
+     * }).detach();
+     * tcp::forward_buffer buffer;
+     * tcp::forward(upstream, client, buffer, ec);
+     * \endcode
+     *
+     * \note SIGPIPE is not raised if destination connection is closed
+     * by peer, error::broken_pipe is reported instead.
+     */
+    forward_result forward(socket& from, socket& to, forward_buffer& buffer, std::error_code& ec,
+                           uint64_t max_bytes = UINT64_MAX) noexcept;
+
+#ifdef __cpp_exceptions
+    /**
+     * Same as overload with error code but throws std::system_error
+     * instead of setting error code argument.
+     *
+     * Note that count of bytes written is lost if exception is thrown.
+     */
+    forward_result forward(socket& from, socket& to, forward_buffer& buffer, uint64_t max_bytes = UINT64_MAX);
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::tcp
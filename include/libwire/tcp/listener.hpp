@@ -78,6 +78,47 @@ namespace libwire::tcp {
             listen(target, backlog);
         }
 
+        /**
+         * Get native handle/descriptor for listening socket.
+         *
+         * Returned value is undefined if \ref listen was not called
+         * or failed.
+         */
+        internal_::socket::native_handle_t native_handle() const noexcept;
+
+        /**
+         * Get reference to underlying socket wrapper.
+         *
+         * Used by generic options (such as \ref non_blocking) and
+         * \ref reactor. **Not part of the public API.**
+         */
+        internal_::socket& implementation() noexcept;
+        const internal_::socket& implementation() const noexcept;
+
+        /**
+         * Allow other listeners to bind to the same endpoint (SO_REUSEPORT),
+         * kernel will distribute incoming connections between them.
+         * Disabled by default. Takes effect on next \ref listen call.
+         *
+         * See \ref listener_group for convenient wrapper.
+         */
+        void set_reuse_port(bool enable) noexcept;
+
+        /**
+         * Check whether SO_REUSEPORT will be set on listening socket,
+         * see \ref set_reuse_port.
+         */
+        bool reuse_port() const noexcept;
+
+        /**
+         * Get endpoint listener is bound to.
+         *
+         * Useful to get actual port when listening on port 0.
+         * Return value is undefined if \ref listen was not called
+         * or failed.
+         */
+        endpoint local_endpoint() const noexcept;
+
         /**
          * Start listening for incoming connections on specified
          * endpoint. backlog argument sets maximum size of
@@ -103,6 +144,21 @@ namespace libwire::tcp {
          */
         socket accept(std::error_code& ec) noexcept;
 
+        /**
+         * Make all sockets returned by \ref accept (and \ref proactor::async_accept)
+         * non-blocking from creation, without extra system calls that
+         * set_option(non_blocking, true) would need. Disabled by default.
+         *
+         * This doesn't change mode of listening socket itself.
+         */
+        void set_accept_non_blocking(bool enable) noexcept;
+
+        /**
+         * Check whether accepted sockets are created in non-blocking mode,
+         * see \ref set_accept_non_blocking.
+         */
+        bool accept_non_blocking() const noexcept;
+
 #ifdef __cpp_exceptions
         /**
          * Same as overload with error code but throws std::system_error
@@ -118,6 +174,11 @@ namespace libwire::tcp {
 #endif // ifdef __cpp_exceptions
 
     private:
-        internal_::socket implementation;
+        internal_::socket impl;
+
+        // Bit mask of internal_::socket::flag values for accepted sockets.
+        unsigned accept_flags = internal_::socket::close_on_exec;
+
+        bool reuse_port_enabled = false;
     };
 } // namespace libwire::tcp
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <system_error>
+#include <libwire/tcp/listener.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file tcp/listener_group.hpp
+ *
+ * This file defines tcp::listener_group type, set of listeners sharing
+ * single endpoint.
+ */
+
+namespace libwire::tcp {
+    /**
+     * Set of listeners bound to the same endpoint using SO_REUSEPORT.
+     *
+     * Each listener has its own accept queue and kernel distributes incoming
+     * connections between them, so each worker thread can accept from its
+     * own listener without contention or thundering herd on shared descriptor.
+     *
+     * Quick usage example:
+     * \code
+     * tcp::listener_group group({ipv4::any, 7777}, std::thread::hardware_concurrency());
+     * for (tcp::listener& l : group) {
+     *     workers.emplace_back([&l]() {
+     *         for (;;) handle(l.accept());
+     *     });
+     * }
+     * \endcode
+     *
+     * \note Supported only on platforms with SO_REUSEPORT (Linux 3.9+,
+     * BSDs). On Linux connections are distributed by hash of connection
+     * 4-tuple, BSDs prior to FreeBSD 12 (SO_REUSEPORT_LB) deliver all
+     * connections to the last listener.
+     *
+     * #### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe (but distinct listeners from same group can be used
+     *   concurrently)
+     */
+    class listener_group {
+    public:
+        using iterator = std::vector<listener>::iterator;
+        using const_iterator = std::vector<listener>::const_iterator;
+
+        /**
+         * Construct empty group.
+         */
+        listener_group() noexcept = default;
+
+        listener_group(const listener_group&) = delete;
+        listener_group(listener_group&&) noexcept = default;
+
+        listener_group& operator=(const listener_group&) = delete;
+        listener_group& operator=(listener_group&&) noexcept = default;
+
+        ~listener_group() = default;
+
+        /**
+         * Construct group and start accepting connections.
+         * See \ref listen documentation for arguments description.
+         */
+        inline listener_group(endpoint target, size_t count, std::error_code& ec,
+                              unsigned backlog = internal_::socket::max_pending_connections) noexcept {
+            listen(target, count, ec, backlog);
+        }
+
+        inline listener_group(endpoint target, size_t count,
+                              unsigned backlog = internal_::socket::max_pending_connections) {
+            listen(target, count, backlog);
+        }
+
+        /**
+         * Open count listeners on target endpoint with SO_REUSEPORT
+         * enabled. backlog is used for each listener.
+         *
+         * If target port is 0 then first listener picks random port and
+         * remaining listeners are bound to it.
+         *
+         * Previously opened listeners are closed. On error group is left
+         * empty and ec is set.
+         */
+        void listen(endpoint target, size_t count, std::error_code& ec,
+                    unsigned max_backlog = internal_::socket::max_pending_connections) noexcept;
+
+        /**
+         * Close all listeners.
+         */
+        void close() noexcept;
+
+        /**
+         * Make sockets accepted by all listeners non-blocking, see
+         * \ref listener::set_accept_non_blocking.
+         */
+        void set_accept_non_blocking(bool enable) noexcept;
+
+        /**
+         * Get endpoint listeners are bound to, \ref endpoint::invalid if
+         * group is empty.
+         */
+        endpoint local_endpoint() const noexcept;
+
+        /**
+         * Count of listeners in group.
+         */
+        size_t size() const noexcept;
+
+        listener& operator[](size_t index) noexcept;
+        const listener& operator[](size_t index) const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void listen(endpoint target, size_t count, unsigned max_backlog = internal_::socket::max_pending_connections);
+#endif // ifdef __cpp_exceptions
+
+    private:
+        std::vector<listener> listeners;
+    };
+} // namespace libwire::tcp
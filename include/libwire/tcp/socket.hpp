@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
 #include <tuple>
 #include <system_error>
 #include <vector>
@@ -42,6 +43,9 @@
  */
 
 namespace libwire::tcp {
+    class forward_buffer;
+    struct forward_result;
+
     /**
      * Descriptor wrapper for TCP socket.
      *
@@ -73,8 +77,11 @@ namespace libwire::tcp {
          *
          * Used by tcp::listener for \ref listener::accept function.
          * **Not part of the public API.**
+         *
+         * If peer is valid - it will be returned by \ref remote_endpoint
+         * instead of querying it from system.
          */
-        socket(internal_::socket&& i) noexcept;
+        socket(internal_::socket&& i, const endpoint& peer = endpoint::invalid) noexcept;
 
         socket(const socket&) = delete;
         socket(socket&&) noexcept = default;
@@ -94,6 +101,15 @@ namespace libwire::tcp {
          */
         internal_::socket::native_handle_t native_handle() const noexcept;
 
+        /**
+         * Get reference to underlying socket wrapper.
+         *
+         * Used by generic options (such as \ref non_blocking) and
+         * \ref reactor. **Not part of the public API.**
+         */
+        internal_::socket& implementation() noexcept;
+        const internal_::socket& implementation() const noexcept;
+
         /**
          * Check whether underlying socket is open.
          *
@@ -218,6 +234,10 @@ namespace libwire::tcp {
          * Get address and port of remote end of connection.
          *
          * Usually same as address/port passed in \ref connect.
+         *
+         * Remote endpoint is remembered by \ref connect and
+         * \ref listener::accept so this function usually doesn't
+         * need any system calls.
          */
         endpoint remote_endpoint() const noexcept;
 
@@ -265,12 +285,13 @@ namespace libwire::tcp {
         ///@{
 
         /**
-         * Read up to bytes_count bytes from socket into buffer passed by
-         * reference. Buffer will be resized to actual count of bytes
-         * received.
+         * Read exactly bytes_count bytes from socket into buffer passed by
+         * reference.
          *
          * Error code will be set to error code if anything went wrong, buffer
-         * will be resized to 0 elements.
+         * will be resized to count of bytes received before error (so no
+         * data is lost if socket is in non-blocking mode and read fails
+         * with error::would_block).
          *
          * **Buffer type requirements:**
          *
@@ -318,7 +339,8 @@ namespace libwire::tcp {
          * Error code will be set if anything went wrong.
          *
          * Returns actual amount of bytes written, usually same as
-         * buffer size unless socket is in non-blocking mode.
+         * buffer size unless socket is in non-blocking mode. See
+         * \ref write_all if you need to write entire buffer.
          *
          * **Buffer type requirements**
          *
@@ -329,6 +351,35 @@ namespace libwire::tcp {
         template<typename Buffer = std::vector<uint8_t>>
         size_t write(const Buffer&, std::error_code&) noexcept;
 
+        /**
+         * Write contents of all buffers in order as one stream of bytes
+         * (gather I/O).
+         *
+         * Buffers are passed to system together, so there is no need to
+         * copy them into one contiguous buffer or to pay for one system
+         * call per buffer. More system calls are made only if system
+         * accepted only part of data.
+         *
+         * Returns total amount of bytes written, same as sum of buffer
+         * sizes unless error occurred.
+         *
+         * \code
+         * sock.write({memory_view(&header, sizeof(header)),
+         *             memory_view(payload.data(), payload.size())});
+         * \endcode
+         */
+        size_t write(std::initializer_list<memory_view> buffers, std::error_code&) noexcept;
+        size_t write(const std::vector<memory_view>& buffers, std::error_code&) noexcept;
+
+        /**
+         * Fill all buffers in order with data read from socket (scatter I/O).
+         *
+         * Returns total amount of bytes read, same as sum of buffer sizes
+         * unless error occurred.
+         */
+        size_t read(std::initializer_list<memory_view> buffers, std::error_code&) noexcept;
+        size_t read(const std::vector<memory_view>& buffers, std::error_code&) noexcept;
+
 #ifdef __cpp_exceptions
         /**
          * Same as overload with error code but throws std::system_error
@@ -353,6 +404,20 @@ namespace libwire::tcp {
         template<typename Buffer = std::vector<uint8_t>>
         size_t write(const Buffer&);
 
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t write(std::initializer_list<memory_view> buffers);
+        size_t write(const std::vector<memory_view>& buffers);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t read(std::initializer_list<memory_view> buffers);
+        size_t read(const std::vector<memory_view>& buffers);
+
         /**
          * Same as overload with error code but throws std::system_error
          * instead of setting error code argument.
@@ -369,8 +434,142 @@ namespace libwire::tcp {
 #endif // ifdef __cpp_exceptions
 
         ///@}
+
+        /**
+         * \name Partial I/O
+         *
+         * I/O functions in this category perform at most one system call
+         * and report how much data was actually transferred, so they can be
+         * used with sockets in non-blocking mode (see \ref non_blocking
+         * and \ref reactor).
+         *
+         * If socket is in non-blocking mode and operation can't make any
+         * progress then error::would_block is reported.
+         */
+        ///@{
+
+        /**
+         * Read up to output.size() bytes from socket into output.
+         *
+         * Returns count of bytes received, buffer is **not** resized.
+         *
+         * **Buffer type requirements:**
+         *
+         * Buffer must be container that encapsulates dynamic array,
+         * so it must have data and size member functions with
+         * behavior as in std::vector. memory_view can be used too.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t read_some(Buffer& output, std::error_code&) noexcept;
+
+        /**
+         * Write up to input.size() bytes from input to socket.
+         *
+         * Returns count of bytes written.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_some(const Buffer& input, std::error_code&) noexcept;
+
+        /**
+         * Write input starting from offset until entire buffer is written
+         * or error occurred. Unlike other functions in this category it can
+         * perform multiple system calls.
+         *
+         * Returns offset of first byte not written yet (input.size() if
+         * everything is written). If socket is in non-blocking mode and
+         * error::would_block is reported then call it again with returned
+         * value as offset when socket will be writable.
+         *
+         * \code
+         * size_t offset = 0;
+         * offset = sock.write_all(buf, ec, offset);
+         * if (ec == error::would_block) {
+         *     // Wait until sock is writable and call write_all with
+         *     // same offset.
+         * }
+         * \endcode
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_all(const Buffer& input, std::error_code&, size_t offset = 0) noexcept;
+
+        /**
+         * Write length bytes of file starting at offset to socket until
+         * everything is written or error occurred. Like \ref write_all it
+         * can perform multiple system calls.
+         *
+         * Where possible (Linux) file contents are passed from page cache
+         * to socket by kernel (sendfile), without copying them to user
+         * space. file should refer to regular file, its current file
+         * offset is not used or changed.
+         *
+         * Returns count of bytes written. If socket is in non-blocking mode
+         * and error::would_block is reported then call it again with offset
+         * and length advanced by returned value when socket will be
+         * writable.
+         *
+         * \code
+         * uint64_t sent = 0;
+         * sent += sock.send_file(fd, sent, size - sent, ec);
+         * if (ec == error::would_block) {
+         *     // Wait until sock is writable and continue from
+         *     // sent bytes.
+         * }
+         * \endcode
+         *
+         * If file ends before offset + length then error::end_of_file is
+         * reported.
+         */
+        uint64_t send_file(internal_::socket::native_file_t file, uint64_t offset, uint64_t length,
+                           std::error_code&) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t read_some(Buffer& output);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_some(const Buffer& input);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         *
+         * Note that offset of first not written byte is lost if
+         * exception is thrown.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_all(const Buffer& input, size_t offset = 0);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         *
+         * Note that count of bytes written is lost if exception is thrown.
+         */
+        uint64_t send_file(internal_::socket::native_file_t file, uint64_t offset, uint64_t length);
+#endif // ifdef __cpp_exceptions
+
+        ///@}
     private:
-        internal_::socket implementation;
+        friend class buffered_socket;
+        friend forward_result forward(socket& from, socket& to, forward_buffer& buffer, std::error_code& ec,
+                                      uint64_t max_bytes) noexcept;
+
+        size_t write_sequence(const memory_view* buffers, size_t count, std::error_code&) noexcept;
+        size_t read_sequence(const memory_view* buffers, size_t count, std::error_code&) noexcept;
+
+        internal_::socket impl;
+
+        // Remote endpoint remembered at connect/accept time,
+        // endpoint::invalid if unknown.
+        endpoint peer = endpoint::invalid;
 
         // Used as internal socket state tracker.
         bool open = false;
@@ -383,17 +582,14 @@ namespace libwire::tcp {
 
         output.resize(bytes_count);
         size_t total_received = 0;
-        // FIXME: Needs to be improved for non-blocking I/O.
         // Read exactly bytes_count bytes, retrying when needed.
         while (total_received < bytes_count) {
-            size_t bytes_received =
-                implementation.read(output.data() + total_received, bytes_count - total_received, ec);
+            total_received += impl.read(output.data() + total_received, bytes_count - total_received, ec);
             if (ec) {
-                if (ec != error::interrupted) {
-                    return output;
-                }
-            };
-            total_received += bytes_received;
+                // Keep bytes received so far.
+                output.resize(total_received);
+                break;
+            }
         }
         open = (ec != error::generic::disconnected);
 
@@ -417,7 +613,7 @@ namespace libwire::tcp {
         static_assert(sizeof(std::remove_pointer_t<decltype(input.data())>) == sizeof(uint8_t),
                       "socket::write can't be used with container with non-byte elements");
 
-        auto res = implementation.write(input.data(), input.size(), ec);
+        auto res = impl.write(input.data(), input.size(), ec);
         open = (ec != error::generic::disconnected);
         return res;
     }
@@ -425,6 +621,45 @@ namespace libwire::tcp {
     extern template size_t socket::write(const std::vector<uint8_t>&, std::error_code&);
     extern template size_t socket::write(const std::string&, std::error_code&);
 
+    template<typename Buffer>
+    size_t socket::read_some(Buffer& output, std::error_code& ec) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(output.data())>) == sizeof(uint8_t),
+                      "socket::read_some can't be used with container with non-byte elements");
+
+        size_t res = impl.read(output.data(), output.size(), ec);
+        open = (ec != error::generic::disconnected);
+        return res;
+    }
+
+    extern template size_t socket::read_some(std::vector<uint8_t>&, std::error_code&);
+    extern template size_t socket::read_some(std::string&, std::error_code&);
+    extern template size_t socket::read_some(memory_view&, std::error_code&);
+
+    template<typename Buffer>
+    size_t socket::write_some(const Buffer& input, std::error_code& ec) noexcept {
+        return write(input, ec);
+    }
+
+    extern template size_t socket::write_some(const std::vector<uint8_t>&, std::error_code&);
+    extern template size_t socket::write_some(const std::string&, std::error_code&);
+
+    template<typename Buffer>
+    size_t socket::write_all(const Buffer& input, std::error_code& ec, size_t offset) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(input.data())>) == sizeof(uint8_t),
+                      "socket::write_all can't be used with container with non-byte elements");
+
+        ec = std::error_code();
+        while (offset < input.size()) {
+            offset += impl.write(input.data() + offset, input.size() - offset, ec);
+            if (ec) break;
+        }
+        open = (ec != error::generic::disconnected);
+        return offset;
+    }
+
+    extern template size_t socket::write_all(const std::vector<uint8_t>&, std::error_code&, size_t);
+    extern template size_t socket::write_all(const std::string&, std::error_code&, size_t);
+
     template<typename Buffer>
     Buffer& socket::read_until(uint8_t delimiter, Buffer& buf, std::error_code& ec, size_t max_size) noexcept {
         uint8_t byte;
@@ -483,6 +718,40 @@ namespace libwire::tcp {
     extern template size_t socket::write(const std::vector<uint8_t>&);
     extern template size_t socket::write(const std::string&);
 
+    template<typename Buffer>
+    size_t socket::read_some(Buffer& output) {
+        std::error_code ec;
+        size_t res = read_some<Buffer>(output, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::read_some(std::vector<uint8_t>&);
+    extern template size_t socket::read_some(std::string&);
+    extern template size_t socket::read_some(memory_view&);
+
+    template<typename Buffer>
+    size_t socket::write_some(const Buffer& input) {
+        std::error_code ec;
+        size_t res = write_some<Buffer>(input, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write_some(const std::vector<uint8_t>&);
+    extern template size_t socket::write_some(const std::string&);
+
+    template<typename Buffer>
+    size_t socket::write_all(const Buffer& input, size_t offset) {
+        std::error_code ec;
+        size_t res = write_all<Buffer>(input, ec, offset);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write_all(const std::vector<uint8_t>&, size_t);
+    extern template size_t socket::write_all(const std::string&, size_t);
+
     template<typename Buffer>
     Buffer& socket::read_until(uint8_t delimiter, Buffer& buf, size_t max_size) {
         std::error_code ec;
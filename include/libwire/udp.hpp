@@ -3,4 +3,7 @@
  */
 namespace libwire::udp {} // namespace libwire::udp
 
-#include "udp/socket.hpp"
\ No newline at end of file
+#include "udp/socket.hpp"
+#include "udp/datagram.hpp"
+#include "udp/options.hpp"
+#include "udp/socket_group.hpp"
\ No newline at end of file
@@ -0,0 +1,259 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <system_error>
+#include <libwire/endpoint.hpp>
+#include <libwire/memory_view.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file udp/datagram.hpp
+ *
+ * This file defines udp::datagram type, descriptor used for batched
+ * datagram I/O, udp::coalesced_datagram type, result of reading
+ * datagrams coalesced by kernel, udp::packet_info type, local side
+ * of datagram, and udp::datagram_info type, result of reading datagram
+ * together with kernel receive information.
+ */
+
+namespace libwire::udp {
+    /**
+     * Description of single datagram for batched I/O, see
+     * \ref socket::read_batch and \ref socket::write_batch.
+     */
+    struct datagram {
+        datagram() noexcept = default;
+
+        /**
+         * Construct descriptor for reading into buffer or writing buffer
+         * to peer (destination set by socket::associate by default).
+         */
+        explicit datagram(memory_view buffer, const endpoint& peer = endpoint::invalid) noexcept
+            : buffer(buffer), peer(peer) {
+        }
+
+        /**
+         * Memory to receive datagram into (read) or datagram contents (write).
+         */
+        memory_view buffer;
+
+        /**
+         * Datagram source (set by read) or destination (used by write).
+         *
+         * For write endpoint::invalid means "use destination set by
+         * socket::associate".
+         */
+        endpoint peer = endpoint::invalid;
+
+        /**
+         * Count of bytes actually received or sent.
+         */
+        size_t size = 0;
+
+        /**
+         * Set by read if datagram was larger than buffer and remaining
+         * bytes were discarded.
+         */
+        bool truncated = false;
+
+        /**
+         * Error occurred while processing this datagram, if any.
+         */
+        std::error_code ec;
+    };
+
+    /**
+     * Local side of datagram: address it was sent to and interface it
+     * was received on (set by read) or address to send it from and
+     * interface to send it through (used by write).
+     *
+     * Allows one socket bound to wildcard address (ipv4::any or
+     * ipv6::any) to serve all local addresses and reply to each request
+     * from address it was sent to, see \ref receive_packet_info.
+     */
+    struct packet_info {
+        /**
+         * Local address, address::invalid means "let system choose"
+         * for write.
+         *
+         * IPv6 sockets report IPv4 datagrams using IPv4-mapped IPv6
+         * addresses (::ffff:a.b.c.d).
+         */
+        address local;
+
+        /**
+         * Index of network interface, 0 means "any" for write.
+         */
+        unsigned interface_index = 0;
+    };
+
+    /**
+     * Datagram received together with information reported by kernel,
+     * see \ref socket::read overload with memory_view.
+     */
+    struct datagram_info {
+        /**
+         * Count of bytes stored in buffer.
+         */
+        size_t size = 0;
+
+        /**
+         * Set if datagram was larger than buffer and remaining bytes
+         * were discarded.
+         */
+        bool truncated = false;
+
+        /**
+         * Datagram source.
+         */
+        endpoint source = endpoint::invalid;
+
+        /**
+         * Time when datagram was received by kernel (system clock),
+         * difference with current time gives time datagram spent in
+         * socket receive queue.
+         *
+         * Set only if \ref receive_timestamp is enabled, zero (clock
+         * epoch) otherwise.
+         */
+        std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> timestamp{};
+
+        /**
+         * Total count of datagrams dropped by socket because its receive
+         * buffer was full, as of time this datagram was queued. Grows
+         * between two reads if datagrams were lost between them.
+         *
+         * Set only if \ref receive_drop_count is enabled, 0 otherwise.
+         */
+        uint32_t drops = 0;
+    };
+
+    /**
+     * One or more datagrams from same source stored back-to-back in
+     * receive buffer, see \ref socket::read_coalesced. All datagrams
+     * have segment_size bytes except last one, which may be shorter.
+     *
+     * Iterating over it yields individual datagrams as memory_view's
+     * pointing into receive buffer, so nothing is copied:
+     * \code
+     * for (memory_view datagram : sock.read_coalesced(buffer, ec)) {
+     *     handle(datagram);
+     * }
+     * \endcode
+     */
+    struct coalesced_datagram {
+        /**
+         * Forward iterator over individual datagrams.
+         */
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = memory_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const memory_view*;
+            using reference = memory_view;
+
+            iterator() noexcept = default;
+
+            iterator(uint8_t* position, uint8_t* end, size_t segment_size) noexcept
+                : position(position), end(end), segment_size(segment_size) {
+            }
+
+            memory_view operator*() const noexcept {
+                return {position, current_size()};
+            }
+
+            iterator& operator++() noexcept {
+                position += current_size();
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const iterator& o) const noexcept {
+                return position == o.position;
+            }
+
+            bool operator!=(const iterator& o) const noexcept {
+                return position != o.position;
+            }
+
+        private:
+            size_t current_size() const noexcept {
+                return std::min(segment_size, size_t(end - position));
+            }
+
+            uint8_t* position = nullptr;
+            uint8_t* end = nullptr;
+            size_t segment_size = 0;
+        };
+
+        /**
+         * Received data, all datagrams together.
+         */
+        memory_view buffer;
+
+        /**
+         * Size of each datagram except last one. Same as buffer.size() if
+         * datagrams were not coalesced.
+         */
+        size_t segment_size = 0;
+
+        /**
+         * Set if received data was larger than buffer and remaining bytes
+         * were discarded.
+         */
+        bool truncated = false;
+
+        iterator begin() const noexcept {
+            return {buffer.data(), buffer.data() + buffer.size(), segment_size == 0 ? buffer.size() : segment_size};
+        }
+
+        iterator end() const noexcept {
+            return {buffer.data() + buffer.size(), buffer.data() + buffer.size(), segment_size};
+        }
+
+        /**
+         * Count of datagrams.
+         */
+        size_t count() const noexcept {
+            if (segment_size == 0) return buffer.size() == 0 ? 0 : 1;
+            return (buffer.size() + segment_size - 1) / segment_size;
+        }
+    };
+} // namespace libwire::udp
@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file udp/options.hpp
+ *
+ * This file defines set of options applicable for use with UDP sockets
+ * using socket.set_option and socket.option.
+ */
+
+namespace libwire::udp {
+    class socket;
+
+    /**
+     * Inline namespace with options applicable for UDP sockets.
+     */
+    inline namespace options {
+        /**
+         * Dummy type for \ref receive_offload option.
+         */
+        struct receive_offload_t {
+            static void set(socket&, bool enabled) noexcept;
+
+            static bool get(const socket&) noexcept;
+        };
+
+        /**
+         * Enable generic receive offload (UDP_GRO) on UDP socket.
+         *
+         * When enabled, kernel can deliver several consecutive datagrams
+         * of same size from same source as one coalesced datagram, this
+         * greatly reduces per-datagram cost of bulk transfers. Use
+         * \ref socket::read_coalesced to split them, other read functions
+         * return coalesced datagrams as is.
+         *
+         * \note Have no effect on systems which don't support this option.
+         * Currently supported only on Linux 5.0+. socket.option(receive_offload)
+         * will always return false on other systems.
+         */
+        constexpr receive_offload_t receive_offload{};
+
+        /**
+         * Dummy type for \ref receive_packet_info option.
+         */
+        struct receive_packet_info_t {
+            static void set(socket&, bool enabled) noexcept;
+
+            static bool get(const socket&) noexcept;
+        };
+
+        /**
+         * Report destination address and interface of received datagrams
+         * (IP_PKTINFO or IPV6_RECVPKTINFO depending on socket IP version).
+         *
+         * Needed by read functions with packet_info argument, without it
+         * packet_info is left unchanged.
+         */
+        constexpr receive_packet_info_t receive_packet_info{};
+
+        /**
+         * Dummy type for \ref receive_timestamp option.
+         */
+        struct receive_timestamp_t {
+            static void set(socket&, bool enabled) noexcept;
+
+            static bool get(const socket&) noexcept;
+        };
+
+        /**
+         * Record time of arrival of every datagram in kernel
+         * (SO_TIMESTAMPNS), reported in datagram_info::timestamp.
+         *
+         * Supported only on Linux, ignored on other systems and get
+         * will always return false.
+         */
+        constexpr receive_timestamp_t receive_timestamp{};
+
+        /**
+         * Dummy type for \ref receive_drop_count option.
+         */
+        struct receive_drop_count_t {
+            static void set(socket&, bool enabled) noexcept;
+
+            static bool get(const socket&) noexcept;
+        };
+
+        /**
+         * Report count of datagrams dropped because of receive buffer
+         * overflow (SO_RXQ_OVFL), reported in datagram_info::drops.
+         *
+         * Supported only on Linux, ignored on other systems and get
+         * will always return false.
+         */
+        constexpr receive_drop_count_t receive_drop_count{};
+    } // namespace options
+} // namespace libwire::udp
@@ -27,6 +27,8 @@
 #include <system_error>
 #include <vector>
 #include <libwire/error.hpp>
+#include <libwire/native_endpoint.hpp>
+#include <libwire/udp/datagram.hpp>
 #include "libwire/internal/bsdsocket.hpp"
 
 /*
@@ -41,6 +43,10 @@
  * This file defines udp::socket type, base class for outgoing UDP communication.
  */
 
+namespace libwire {
+    struct non_blocking_t;
+} // namespace libwire
+
 namespace libwire::udp {
     /**
      * Descriptor wrapper for UDP socket.
@@ -68,6 +74,16 @@ namespace libwire::udp {
          */
         socket(ip ipver) noexcept;
 
+        /**
+         * Create new socket object in non-blocking mode, without extra
+         * system calls that set_option(non_blocking, true) would need.
+         *
+         * \code
+         * udp::socket sock(ip::v4, non_blocking);
+         * \endcode
+         */
+        socket(ip ipver, non_blocking_t) noexcept;
+
         socket(const socket&) = delete;
         socket(socket&&) noexcept = default;
 
@@ -100,7 +116,8 @@ namespace libwire::udp {
          * Several aspects of socket behavior can be changes by setting flags.
          *
          * See \ref tcp::socket documentation for detailed explanation of socket
-         * options mechanism. There are no special options for UDP sockets.
+         * options mechanism. Options specific to UDP sockets are defined in
+         * udp/options.hpp.
          */
         ///@{
 
@@ -216,6 +233,62 @@ namespace libwire::udp {
         template<typename Buffer = std::vector<uint8_t>>
         size_t write(const Buffer&, std::error_code&, const endpoint& dest = endpoint::invalid) noexcept;
 
+        /**
+         * Same as read with endpoint but source is stored in form used by
+         * operating system, without conversion.
+         *
+         * Use it together with write overload accepting native_endpoint
+         * to reply to datagram source, see \ref native_endpoint.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, std::error_code&, native_endpoint& source) noexcept;
+
+        /**
+         * Same as write with endpoint but destination is already in form
+         * used by operating system, so no conversion is done.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, std::error_code&, const native_endpoint& dest) noexcept;
+
+        /**
+         * Same as read with endpoint but also store address datagram was
+         * sent to and interface it was received on into destination.
+         *
+         * Requires \ref receive_packet_info option to be enabled, otherwise
+         * destination is left unchanged. Not supported on Windows.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, std::error_code&, endpoint& source,
+                     packet_info& destination) noexcept;
+
+        /**
+         * Same as read with packet_info but source is stored in form used
+         * by operating system, without conversion.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, std::error_code&, native_endpoint& source,
+                     packet_info& destination) noexcept;
+
+        /**
+         * Same as write with endpoint but send datagram from address and
+         * through interface specified in source, so socket bound to
+         * wildcard address can reply from address request was sent to
+         * (see read with packet_info).
+         *
+         * Address must be assigned to one of local interfaces. Not
+         * supported on Windows.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, std::error_code&, const endpoint& dest, const packet_info& source) noexcept;
+
+        /**
+         * Same as write with packet_info but destination is already in
+         * form used by operating system, so no conversion is done.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, std::error_code&, const native_endpoint& dest,
+                     const packet_info& source) noexcept;
+
 #ifdef __cpp_exceptions
         /**
          * Same as overload with error code but throws std::system_error
@@ -245,6 +318,223 @@ namespace libwire::udp {
          */
         template<typename Buffer = std::vector<uint8_t>>
         size_t write(const Buffer&, const endpoint& dest = endpoint::invalid);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, native_endpoint& source);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, const native_endpoint& dest);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, endpoint& source, packet_info& destination);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        Buffer& read(size_t bytes_count, Buffer&, native_endpoint& source, packet_info& destination);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, const endpoint& dest, const packet_info& source);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write(const Buffer&, const native_endpoint& dest, const packet_info& source);
+#endif // ifdef __cpp_exceptions
+
+        ///@}
+
+        /**
+         * \name Batched I/O
+         *
+         * Functions in this category transfer multiple datagrams using single
+         * system call where platform supports it (recvmmsg/sendmmsg on Linux),
+         * which greatly reduces per-datagram overhead under high packet rates.
+         * On other platforms they fall back to one call per datagram.
+         *
+         * Each datagram is described by \ref datagram structure which receives
+         * per-datagram result (size, source, error). At most
+         * internal_::socket::max_datagrams datagrams are processed by one call,
+         * remaining ones are left untouched.
+         */
+        ///@{
+
+        /**
+         * Receive up to count datagrams into buffers specified by
+         * datagrams[i].buffer. Buffers are never resized, datagram
+         * larger than its buffer is truncated and marked as such.
+         *
+         * Blocks only until first datagram is available (unless socket
+         * is in non-blocking mode), then collects all datagrams already
+         * queued without waiting for more.
+         *
+         * Returns count of datagrams received, only first N entries are
+         * updated. ec and datagrams[0].ec will be set if nothing was received.
+         */
+        size_t read_batch(datagram* datagrams, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Same as overload with pointer and count but uses all elements
+         * of vector.
+         */
+        size_t read_batch(std::vector<datagram>& datagrams, std::error_code& ec) noexcept;
+
+        /**
+         * Send up to count datagrams. datagrams[i].peer is used as destination,
+         * endpoint::invalid means "use destination set by \ref associate".
+         *
+         * Returns count of datagrams sent and sets datagrams[i].size for them.
+         * If returned value is less than count - caller should retry with
+         * remaining datagrams. ec and datagrams[0].ec will be set if nothing
+         * was sent.
+         */
+        size_t write_batch(datagram* datagrams, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Same as overload with pointer and count but uses all elements
+         * of vector.
+         */
+        size_t write_batch(std::vector<datagram>& datagrams, std::error_code& ec) noexcept;
+
+        /**
+         * Send contents of buffer as sequence of datagrams, segment_size
+         * bytes each (last one may be shorter). dest argument will override
+         * destination specified using \ref associate.
+         *
+         * On Linux with generic segmentation offload (UDP_SEGMENT) buffer
+         * is split into datagrams by kernel (or network card), so dozens of
+         * datagrams pass through network stack once using one system call.
+         * Otherwise datagrams are sent in batches as by \ref write_batch.
+         *
+         * Returns count of bytes sent. If returned value is less than buffer
+         * size - caller should retry with remaining data, returned value is
+         * always multiple of segment_size in this case.
+         *
+         * **Buffer type requirements**
+         *
+         * Buffer must be container that encapsulates dynamic array,
+         * so it must have data and size member functions with
+         * behavior as in std::vector.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_segmented(const Buffer&, size_t segment_size, std::error_code&,
+                               const endpoint& dest = endpoint::invalid) noexcept;
+
+        /**
+         * Same as write_segmented with endpoint but destination is already
+         * in form used by operating system, so no conversion is done.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_segmented(const Buffer&, size_t segment_size, std::error_code&,
+                               const native_endpoint& dest) noexcept;
+
+        /**
+         * Receive pending datagram into buffer, buffer is not resized.
+         *
+         * If \ref receive_offload is enabled then kernel can deliver several
+         * datagrams from same source at once, returned object allows to
+         * iterate over them without copying. Buffer should be large enough
+         * for coalesced datagrams (up to 64 KiB), otherwise excess is
+         * discarded and truncated flag is set.
+         *
+         * If source contains non-null pointer, datagram source endpoint will
+         * be written to it.
+         */
+        coalesced_datagram read_coalesced(memory_view buffer, std::error_code&, endpoint* source = nullptr) noexcept;
+
+        /**
+         * Same as read_coalesced with endpoint but source is stored in form
+         * used by operating system, without conversion.
+         */
+        coalesced_datagram read_coalesced(memory_view buffer, std::error_code&, native_endpoint& source) noexcept;
+
+        /**
+         * Receive pending datagram into buffer, buffer is not resized.
+         *
+         * In addition to size and source returned object contains kernel
+         * receive timestamp and socket drop counter if \ref
+         * receive_timestamp and \ref receive_drop_count options are
+         * enabled, see \ref datagram_info. Excess of datagram larger than
+         * buffer is discarded and truncated flag is set.
+         */
+        datagram_info read(memory_view buffer, std::error_code&) noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t read_batch(datagram* datagrams, size_t count);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t read_batch(std::vector<datagram>& datagrams);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t write_batch(datagram* datagrams, size_t count);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        size_t write_batch(std::vector<datagram>& datagrams);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_segmented(const Buffer&, size_t segment_size, const endpoint& dest = endpoint::invalid);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        template<typename Buffer = std::vector<uint8_t>>
+        size_t write_segmented(const Buffer&, size_t segment_size, const native_endpoint& dest);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        coalesced_datagram read_coalesced(memory_view buffer, endpoint* source = nullptr);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        coalesced_datagram read_coalesced(memory_view buffer, native_endpoint& source);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        datagram_info read(memory_view buffer);
 #endif // ifdef __cpp_exceptions
 
         ///@}
@@ -298,6 +588,122 @@ namespace libwire::udp {
     extern template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const endpoint&);
     extern template size_t socket::write(const std::string&, std::error_code&, const endpoint&);
 
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, std::error_code& ec, native_endpoint& source) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(output.data())>) == sizeof(uint8_t),
+                      "socket::read can't be used with container with non-byte elements");
+
+        output.resize(bytes_count);
+        size_t bytes_received = impl.recvfrom(output.data(), bytes_count, source, ec);
+        if (ec) return output;
+        output.resize(bytes_received);
+
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&,
+                                                       native_endpoint&);
+    extern template std::string& socket::read(size_t, std::string&, std::error_code&, native_endpoint&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, std::error_code& ec, const native_endpoint& dest) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(input.data())>) == sizeof(uint8_t),
+                      "socket::write can't be used with container with non-byte elements");
+
+        return impl.sendto(input.data(), input.size(), dest, ec);
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const native_endpoint&);
+    extern template size_t socket::write(const std::string&, std::error_code&, const native_endpoint&);
+
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, std::error_code& ec, endpoint& source,
+                         packet_info& destination) noexcept {
+        native_endpoint native_source;
+        read(bytes_count, output, ec, native_source, destination);
+        if (!ec) source = native_source.to_endpoint();
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&, endpoint&,
+                                                       packet_info&);
+    extern template std::string& socket::read(size_t, std::string&, std::error_code&, endpoint&, packet_info&);
+
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, std::error_code& ec, native_endpoint& source,
+                         packet_info& destination) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(output.data())>) == sizeof(uint8_t),
+                      "socket::read can't be used with container with non-byte elements");
+
+        output.resize(bytes_count);
+        size_t bytes_received = impl.recvfrom(output.data(), bytes_count, source, destination, ec);
+        if (ec) return output;
+        output.resize(bytes_received);
+
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&,
+                                                       native_endpoint&, packet_info&);
+    extern template std::string& socket::read(size_t, std::string&, std::error_code&, native_endpoint&,
+                                              packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, std::error_code& ec, const endpoint& dest,
+                         const packet_info& source) noexcept {
+        if (dest.is_invalid()) { // associated destination
+            return write(input, ec, native_endpoint(), source);
+        } else {
+            return write(input, ec, native_endpoint(dest), source);
+        }
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const endpoint&,
+                                         const packet_info&);
+    extern template size_t socket::write(const std::string&, std::error_code&, const endpoint&, const packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, std::error_code& ec, const native_endpoint& dest,
+                         const packet_info& source) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(input.data())>) == sizeof(uint8_t),
+                      "socket::write can't be used with container with non-byte elements");
+
+        return impl.sendto(input.data(), input.size(), dest, source, ec);
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const native_endpoint&,
+                                         const packet_info&);
+    extern template size_t socket::write(const std::string&, std::error_code&, const native_endpoint&,
+                                         const packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write_segmented(const Buffer& input, size_t segment_size, std::error_code& ec,
+                                   const endpoint& dest) noexcept {
+        if (dest.is_invalid()) { // default value
+            return write_segmented(input, segment_size, ec, native_endpoint());
+        } else {
+            return write_segmented(input, segment_size, ec, native_endpoint(dest));
+        }
+    }
+
+    extern template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, std::error_code&,
+                                                   const endpoint&);
+    extern template size_t socket::write_segmented(const std::string&, size_t, std::error_code&, const endpoint&);
+
+    template<typename Buffer>
+    size_t socket::write_segmented(const Buffer& input, size_t segment_size, std::error_code& ec,
+                                   const native_endpoint& dest) noexcept {
+        static_assert(sizeof(std::remove_pointer_t<decltype(input.data())>) == sizeof(uint8_t),
+                      "socket::write_segmented can't be used with container with non-byte elements");
+
+        return impl.sendto_segmented(input.data(), input.size(), segment_size, dest, ec);
+    }
+
+    extern template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, std::error_code&,
+                                                   const native_endpoint&);
+    extern template size_t socket::write_segmented(const std::string&, size_t, std::error_code&,
+                                                   const native_endpoint&);
+
 #ifdef __cpp_exceptions
     template<typename Buffer>
     Buffer& socket::read(size_t bytes_count, Buffer& output, endpoint* source) {
@@ -329,5 +735,94 @@ namespace libwire::udp {
 
     extern template size_t socket::write(const std::vector<uint8_t>&, const endpoint&);
     extern template size_t socket::write(const std::string&, const endpoint&);
+
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, native_endpoint& source) {
+        std::error_code ec;
+        read<Buffer>(bytes_count, output, ec, source);
+        if (ec) throw std::system_error(ec);
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, native_endpoint&);
+    extern template std::string& socket::read(size_t, std::string&, native_endpoint&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, const native_endpoint& dest) {
+        std::error_code ec;
+        size_t res = write<Buffer>(input, ec, dest);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, const native_endpoint&);
+    extern template size_t socket::write(const std::string&, const native_endpoint&);
+
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, endpoint& source, packet_info& destination) {
+        std::error_code ec;
+        read<Buffer>(bytes_count, output, ec, source, destination);
+        if (ec) throw std::system_error(ec);
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, endpoint&, packet_info&);
+    extern template std::string& socket::read(size_t, std::string&, endpoint&, packet_info&);
+
+    template<typename Buffer>
+    Buffer& socket::read(size_t bytes_count, Buffer& output, native_endpoint& source, packet_info& destination) {
+        std::error_code ec;
+        read<Buffer>(bytes_count, output, ec, source, destination);
+        if (ec) throw std::system_error(ec);
+        return output;
+    }
+
+    extern template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, native_endpoint&,
+                                                       packet_info&);
+    extern template std::string& socket::read(size_t, std::string&, native_endpoint&, packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, const endpoint& dest, const packet_info& source) {
+        std::error_code ec;
+        size_t res = write<Buffer>(input, ec, dest, source);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, const endpoint&, const packet_info&);
+    extern template size_t socket::write(const std::string&, const endpoint&, const packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write(const Buffer& input, const native_endpoint& dest, const packet_info& source) {
+        std::error_code ec;
+        size_t res = write<Buffer>(input, ec, dest, source);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write(const std::vector<uint8_t>&, const native_endpoint&, const packet_info&);
+    extern template size_t socket::write(const std::string&, const native_endpoint&, const packet_info&);
+
+    template<typename Buffer>
+    size_t socket::write_segmented(const Buffer& input, size_t segment_size, const endpoint& dest) {
+        std::error_code ec;
+        size_t res = write_segmented<Buffer>(input, segment_size, ec, dest);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, const endpoint&);
+    extern template size_t socket::write_segmented(const std::string&, size_t, const endpoint&);
+
+    template<typename Buffer>
+    size_t socket::write_segmented(const Buffer& input, size_t segment_size, const native_endpoint& dest) {
+        std::error_code ec;
+        size_t res = write_segmented<Buffer>(input, segment_size, ec, dest);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    extern template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, const native_endpoint&);
+    extern template size_t socket::write_segmented(const std::string&, size_t, const native_endpoint&);
 #endif // ifdef __cpp_exceptions
 } // namespace libwire::udp
@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <vector>
+#include <system_error>
+#include <libwire/udp/socket.hpp>
+
+/*
+ * If you had to open this file to find answer for your question - we are so
+ * sorry. Please open issue with your question so we can update documentation
+ * to answer it.
+ */
+
+/**
+ * \file udp/socket_group.hpp
+ *
+ * This file defines udp::socket_group type, set of sockets sharing
+ * single endpoint.
+ */
+
+namespace libwire::udp {
+    /**
+     * Set of sockets bound to the same endpoint using SO_REUSEPORT.
+     *
+     * Each socket has its own receive queue and kernel distributes incoming
+     * datagrams between them, so each worker thread can read from its own
+     * socket and receive queue is not limited by speed of single thread.
+     *
+     * Quick usage example:
+     * \code
+     * udp::socket_group group({ipv4::any, 7777}, std::thread::hardware_concurrency());
+     * for (udp::socket& s : group) {
+     *     workers.emplace_back([&s]() {
+     *         for (;;) handle(s.read(...));
+     *     });
+     * }
+     * \endcode
+     *
+     * By default datagrams are distributed by hash of source and
+     * destination endpoints, see \ref steer_by_cpu for alternative.
+     *
+     * \note Supported only on platforms with SO_REUSEPORT (Linux 3.9+,
+     * BSDs). BSDs prior to FreeBSD 12 (SO_REUSEPORT_LB) deliver all
+     * datagrams to the last socket.
+     *
+     * #### Thread-safety
+     * * Distinct: safe
+     * * Same: unsafe (but distinct sockets from same group can be used
+     *   concurrently)
+     */
+    class socket_group {
+    public:
+        using iterator = std::vector<socket>::iterator;
+        using const_iterator = std::vector<socket>::const_iterator;
+
+        /**
+         * Construct empty group.
+         */
+        socket_group() noexcept = default;
+
+        socket_group(const socket_group&) = delete;
+        socket_group(socket_group&&) noexcept = default;
+
+        socket_group& operator=(const socket_group&) = delete;
+        socket_group& operator=(socket_group&&) noexcept = default;
+
+        ~socket_group() = default;
+
+        /**
+         * Construct group and bind sockets.
+         * See \ref listen documentation for arguments description.
+         */
+        inline socket_group(endpoint target, size_t count, std::error_code& ec) noexcept {
+            listen(target, count, ec);
+        }
+
+#ifdef __cpp_exceptions
+        inline socket_group(endpoint target, size_t count) {
+            listen(target, count);
+        }
+#endif // ifdef __cpp_exceptions
+
+        /**
+         * Open count sockets and bind them to target endpoint with
+         * SO_REUSEPORT enabled.
+         *
+         * If target port is 0 then first socket picks random port and
+         * remaining sockets are bound to it.
+         *
+         * Previously opened sockets are closed. On error group is left
+         * empty and ec is set.
+         */
+        void listen(endpoint target, size_t count, std::error_code& ec) noexcept;
+
+        /**
+         * Deliver datagrams to socket with index equal to index of CPU
+         * which received them modulo group size (using classic BPF program
+         * attached with SO_ATTACH_REUSEPORT_CBPF), instead of hashing.
+         *
+         * Combined with NIC receive queues bound to distinct CPUs and
+         * worker of each socket pinned to corresponding CPU it keeps
+         * datagram on one CPU from interrupt to application.
+         *
+         * Sockets are indexed in order they were bound, so closing one
+         * socket of group (see socket::close) breaks this mapping.
+         *
+         * Supported only on Linux 4.5+, ec is set to not_supported on
+         * other systems.
+         */
+        void steer_by_cpu(std::error_code& ec) noexcept;
+
+        /**
+         * Close all sockets.
+         */
+        void close() noexcept;
+
+        /**
+         * Get endpoint sockets are bound to, \ref endpoint::invalid if
+         * group is empty.
+         */
+        endpoint local_endpoint() const noexcept;
+
+        /**
+         * Count of sockets in group.
+         */
+        size_t size() const noexcept;
+
+        socket& operator[](size_t index) noexcept;
+        const socket& operator[](size_t index) const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+#ifdef __cpp_exceptions
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void listen(endpoint target, size_t count);
+
+        /**
+         * Same as overload with error code but throws std::system_error
+         * instead of setting error code argument.
+         */
+        void steer_by_cpu();
+#endif // ifdef __cpp_exceptions
+
+    private:
+        std::vector<socket> sockets;
+    };
+} // namespace libwire::udp
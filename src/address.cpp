@@ -20,20 +20,11 @@
  * SOFTWARE.
  */
 
-#define _WIN32_WINNT 0x600 // Windows Vista+, required for inet_pton.
-
 #include <libwire/address.hpp>
 #include <cassert>
 #include <algorithm>
-#include "libwire/internal/platform.hpp"
-
-#if defined(LIBWIRE_POSIX)
-#    include <arpa/inet.h>
-#endif
-#if defined(LIBWIRE_WINDOWS)
-#    include <winsock2.h>
-#    include <ws2tcpip.h>
-#endif
+#include <ostream>
+#include "libwire/internal/system_errors.hpp"
 
 namespace libwire {
     const address address::invalid;
@@ -55,42 +46,276 @@ namespace libwire {
         : version(ip::v6), parts{o1, o2, o3, o4, o5, o6, o7, o8, o9, o10, o11, o12, o13, o14, o15, o16} {
     }
 
-    address::address(const std::string& text_ip, ip assume_ipver) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL) {
-        int family;
-        if (assume_ipver == ip(0)) {
-            family = AF_INET;
-            version = ip::v4;
-            for (const char& ch : text_ip) {
-                if (ch == ':') {
-                    family = AF_INET6;
-                    version = ip::v6;
+    namespace {
+        // Lookup table for hex digits, 0xFF for non-digits. Table lookup
+        // instead of comparison chains keeps digit loops branch-light.
+        constexpr std::array<uint8_t, 256> make_hex_table() {
+            std::array<uint8_t, 256> table{};
+            for (auto& entry : table) entry = 0xFF;
+            for (int i = 0; i < 10; ++i) table['0' + i] = uint8_t(i);
+            for (int i = 0; i < 6; ++i) {
+                table['a' + i] = uint8_t(10 + i);
+                table['A' + i] = uint8_t(10 + i);
+            }
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> hex_table = make_hex_table();
+
+        inline unsigned digit_value(char ch) noexcept {
+            auto value = unsigned(uint8_t(ch) - uint8_t('0'));
+            return value < 10 ? value : 0xFF;
+        }
+
+        inline unsigned hex_value(char ch) noexcept {
+            return hex_table[uint8_t(ch)];
+        }
+
+        /**
+         * Parse dotted-quad IPv4 address into 4 bytes pointed by out.
+         *
+         * Octets with leading zeros ("01") are rejected, same as inet_pton does.
+         */
+        bool parse_ipv4(std::string_view text, uint8_t* out) noexcept {
+            const char* it = text.data();
+            const char* end = it + text.size();
+            for (int octet = 0; octet < 4; ++octet) {
+                if (octet != 0) {
+                    if (it == end || *it != '.') return false;
+                    ++it;
+                }
+
+                const char* start = it;
+                unsigned value = 0;
+                while (it != end && it - start < 3) {
+                    unsigned digit = digit_value(*it);
+                    if (digit > 9) break;
+                    value = value * 10 + digit;
+                    ++it;
+                }
+                if (it == start || value > 255) return false;
+                if (it - start > 1 && *start == '0') return false;
+                out[octet] = uint8_t(value);
+            }
+            return it == end;
+        }
+
+        /**
+         * Parse IPv6 address (RFC 4291, section 2.2) into 16 bytes
+         * pointed by out.
+         */
+        bool parse_ipv6(std::string_view text, uint8_t* out) noexcept {
+            std::array<uint16_t, 8> groups{};
+            size_t count = 0;
+            constexpr size_t no_gap = size_t(-1);
+            size_t gap = no_gap; // Position of "::".
+
+            const char* it = text.data();
+            const char* end = it + text.size();
+            if (it != end && *it == ':') {
+                // Only "::" can be at beginning.
+                if (end - it < 2 || it[1] != ':') return false;
+                gap = 0;
+                it += 2;
+            }
+
+            while (it != end) {
+                if (count == groups.size()) return false;
+
+                const char* start = it;
+                unsigned value = 0;
+                while (it != end && it - start < 4) {
+                    unsigned digit = hex_value(*it);
+                    if (digit > 0xF) break;
+                    value = (value << 4u) | digit;
+                    ++it;
+                }
+                if (it == start) return false;
+
+                if (it != end && *it == '.') {
+                    // Embedded IPv4 address, occupies last 32 bits.
+                    if (count > groups.size() - 2) return false;
+                    std::array<uint8_t, 4> ipv4{};
+                    if (!parse_ipv4(std::string_view(start, size_t(end - start)), ipv4.data())) return false;
+                    groups[count++] = uint16_t(ipv4[0] << 8u | ipv4[1]);
+                    groups[count++] = uint16_t(ipv4[2] << 8u | ipv4[3]);
+                    it = end;
+                    break;
+                }
+
+                groups[count++] = uint16_t(value);
+                if (it == end) break;
+                if (*it != ':') return false;
+                ++it;
+                if (it != end && *it == ':') {
+                    if (gap != no_gap) return false; // Only one "::" allowed.
+                    gap = count;
+                    ++it;
+                } else if (it == end) {
+                    return false; // Trailing single ':'.
                 }
             }
+
+            if (gap == no_gap) {
+                if (count != groups.size()) return false;
+            } else {
+                // "::" should replace at least one group.
+                if (count == groups.size()) return false;
+                size_t tail = count - gap;
+                std::copy_backward(groups.begin() + gap, groups.begin() + count, groups.end());
+                std::fill(groups.begin() + gap, groups.end() - tail, 0);
+            }
+
+            for (size_t i = 0; i < groups.size(); ++i) {
+                out[i * 2] = uint8_t(groups[i] >> 8u);
+                out[i * 2 + 1] = uint8_t(groups[i] & 0xFFu);
+            }
+            return true;
+        }
+    } // namespace
+
+    address address::parse(std::string_view text_ip, std::error_code& ec, ip assume_ipver) noexcept {
+        ec = std::error_code();
+        address result;
+        if (assume_ipver == ip(0)) {
+            bool has_colon = text_ip.find(':') != std::string_view::npos;
+            result.version = has_colon ? ip::v6 : ip::v4;
         } else {
-            family = (assume_ipver == ip::v4) ? AF_INET : AF_INET6;
-            version = assume_ipver;
+            result.version = assume_ipver;
         }
 
-        if (inet_pton(family, text_ip.data(), parts.data()) <= 0) {
-            *this = invalid;
+        bool success = (result.version == ip::v4) ? parse_ipv4(text_ip, result.parts.data())
+                                                  : parse_ipv6(text_ip, result.parts.data());
+        if (!success) {
+            ec = internal_::invalid_argument_error();
+            return invalid;
+        }
+        return result;
+    }
+
+    address::address(const std::string& text_ip, ip assume_ipver) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL) {
+        std::error_code ec;
+        *this = parse(text_ip, ec, assume_ipver);
 #ifdef __cpp_exceptions
-            throw std::invalid_argument("invalid address string");
+        if (ec) throw std::invalid_argument("invalid address string");
 #endif
-        }
     }
 
-    std::string address::to_string() const noexcept {
+#ifdef __cpp_exceptions
+    address address::parse(std::string_view text_ip, ip assume_ipver) {
+        std::error_code ec;
+        address result = parse(text_ip, ec, assume_ipver);
+        if (ec) throw std::system_error(ec);
+        return result;
+    }
+#endif // ifdef __cpp_exceptions
+
+    namespace {
+        constexpr char hex_digits[] = "0123456789abcdef";
+
+        /**
+         * Write decimal octet, out should have space for 3 characters.
+         */
+        inline char* write_octet(char* out, uint8_t value) noexcept {
+            if (value >= 100) {
+                *out++ = char('0' + value / 100);
+                *out++ = char('0' + value / 10 % 10);
+            } else if (value >= 10) {
+                *out++ = char('0' + value / 10);
+            }
+            *out++ = char('0' + value % 10);
+            return out;
+        }
+
+        inline char* write_ipv4(char* out, const uint8_t* octets) noexcept {
+            out = write_octet(out, octets[0]);
+            for (int i = 1; i < 4; ++i) {
+                *out++ = '.';
+                out = write_octet(out, octets[i]);
+            }
+            return out;
+        }
+
+        /**
+         * Write hex group without leading zeros, out should have space for 4 characters.
+         */
+        inline char* write_group(char* out, uint16_t value) noexcept {
+            unsigned shift = 12;
+            while (shift > 0 && ((value >> shift) & 0xFu) == 0) shift -= 4;
+            for (;; shift -= 4) {
+                *out++ = hex_digits[(value >> shift) & 0xFu];
+                if (shift == 0) break;
+            }
+            return out;
+        }
+
+        /**
+         * Write IPv6 address in RFC 5952 form (same as inet_ntop output).
+         */
+        char* write_ipv6(char* out, const uint8_t* bytes) noexcept {
+            std::array<uint16_t, 8> groups;
+            for (size_t i = 0; i < groups.size(); ++i) {
+                groups[i] = uint16_t(unsigned(bytes[i * 2]) << 8u | bytes[i * 2 + 1]);
+            }
+
+            // Find longest run of zero groups (first one if tied), only runs
+            // of two and more groups are compressed.
+            size_t best_start = 0, best_length = 0;
+            for (size_t i = 0; i < groups.size();) {
+                if (groups[i] != 0) {
+                    ++i;
+                    continue;
+                }
+                size_t start = i;
+                while (i < groups.size() && groups[i] == 0) ++i;
+                if (i - start > best_length) {
+                    best_start = start;
+                    best_length = i - start;
+                }
+            }
+            if (best_length < 2) best_length = 0;
+
+            for (size_t i = 0; i < groups.size(); ++i) {
+                if (best_length != 0 && i == best_start) {
+                    *out++ = ':';
+                    i += best_length - 1;
+                    if (i == groups.size() - 1) *out++ = ':';
+                    continue;
+                }
+                if (i != 0) *out++ = ':';
+
+                // IPv4-compatible (::a.b.c.d) and IPv4-mapped (::ffff:a.b.c.d)
+                // addresses have last 32 bits written as dotted quad.
+                if (i == 6 && best_start == 0 && (best_length == 6 || (best_length == 5 && groups[5] == 0xffff))) {
+                    return write_ipv4(out, bytes + 12);
+                }
+                out = write_group(out, groups[i]);
+            }
+            return out;
+        }
+    } // namespace
+
+    std::to_chars_result address::to_chars(char* first, char* last) const noexcept {
         assert(!is_invalid());
-        int family = (version == ip::v4) ? AF_INET : AF_INET6;
 
-        // 45 - maximum possible IPv6 address length.
-        std::array<char, 45> buffer;
+        std::array<char, max_text_length> buffer;
+        char* end = (version == ip::v4) ? write_ipv4(buffer.data(), parts.data())
+                                        : write_ipv6(buffer.data(), parts.data());
+        auto length = size_t(end - buffer.data());
+        if (size_t(last - first) < length) return {last, std::errc::value_too_large};
+        return {std::copy(buffer.data(), end, first), std::errc()};
+    }
 
-        // const_cast is required on Windows because function accepts PVOID (void*).
-        const char* buf_ptr = inet_ntop(family, const_cast<uint8_t*>(parts.data()), buffer.data(), buffer.size());
-        assert(buf_ptr != nullptr); // This function generally should not fail.
+    std::string address::to_string() const noexcept {
+        std::array<char, max_text_length> buffer;
+        auto result = to_chars(buffer.data(), buffer.data() + buffer.size());
+        return std::string(buffer.data(), result.ptr);
+    }
 
-        return std::string(buffer.data());
+    std::ostream& operator<<(std::ostream& stream, const address& addr) {
+        std::array<char, address::max_text_length> buffer;
+        auto result = addr.to_chars(buffer.data(), buffer.data() + buffer.size());
+        return stream.write(buffer.data(), result.ptr - buffer.data());
     }
 
     bool address::operator==(const address& o) const noexcept {
@@ -105,16 +330,3 @@ namespace libwire {
         return version == ip(0);
     }
 } // namespace libwire
-
-namespace std { // NOLINT(cert-dcl58-cpp)
-    std::size_t hash<libwire::address>::operator()(const libwire::address& addr) const noexcept {
-        std::hash<uint8_t> hash;
-        auto result = std::size_t(addr.version);
-        for (const uint8_t& i : addr.parts) {
-            // See
-            // https://stackoverflow.com/questions/4948780/magic-number-in-boosthash-combine
-            result ^= hash(i) + 0x9e3779b9u + (result << 6u) + (result >> 2u);
-        }
-        return result;
-    }
-} // namespace std
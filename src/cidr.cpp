@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/cidr.hpp"
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <ostream>
+#include "libwire/internal/system_errors.hpp"
+
+namespace libwire {
+    const cidr cidr::invalid;
+
+    cidr::cidr(const address& addr, uint8_t prefix_length) noexcept
+        : addr(addr), prefix_length(std::min(prefix_length, max_prefix_length(addr.version))) {
+        assert(!addr.is_invalid());
+
+        // Clear host bits.
+        size_t full_bytes = this->prefix_length / 8u;
+        if (full_bytes < this->addr.parts.size()) {
+            this->addr.parts[full_bytes] &= uint8_t(0xFF00u >> (this->prefix_length % 8u));
+            std::fill(this->addr.parts.begin() + full_bytes + 1, this->addr.parts.end(), uint8_t(0));
+        }
+    }
+
+    cidr::cidr(std::string_view str) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL) {
+        std::error_code ec;
+        *this = parse(str, ec);
+#ifdef __cpp_exceptions
+        if (ec) throw std::invalid_argument("invalid prefix string");
+#endif
+    }
+
+    cidr cidr::parse(std::string_view str, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        size_t slash = str.find('/');
+        address addr = address::parse(str.substr(0, slash), ec);
+        if (ec) return invalid;
+
+        uint8_t max_length = max_prefix_length(addr.version);
+        if (slash == std::string_view::npos) return cidr(addr, max_length);
+
+        // Decimal 0-128 without leading zeros.
+        std::string_view length_str = str.substr(slash + 1);
+        unsigned length = 0;
+        bool valid = !length_str.empty() && length_str.size() <= 3 && (length_str[0] != '0' || length_str.size() == 1);
+        for (size_t i = 0; valid && i < length_str.size(); ++i) {
+            auto digit = unsigned(uint8_t(length_str[i]) - uint8_t('0'));
+            valid = digit <= 9;
+            length = length * 10 + digit;
+        }
+        if (!valid || length > max_length) {
+            ec = internal_::invalid_argument_error();
+            return invalid;
+        }
+        return cidr(addr, uint8_t(length));
+    }
+
+#ifdef __cpp_exceptions
+    cidr cidr::parse(std::string_view str) {
+        std::error_code ec;
+        cidr result = parse(str, ec);
+        if (ec) throw std::system_error(ec);
+        return result;
+    }
+#endif // ifdef __cpp_exceptions
+
+    uint8_t cidr::max_prefix_length(ip version) noexcept {
+        return version == ip::v4 ? 32 : 128;
+    }
+
+    bool cidr::contains(const address& other) const noexcept {
+        if (other.version != addr.version) return false;
+
+        size_t full_bytes = prefix_length / 8u;
+        if (!std::equal(addr.parts.begin(), addr.parts.begin() + full_bytes, other.parts.begin())) return false;
+        if (prefix_length % 8u == 0) return true;
+
+        auto mask = uint8_t(0xFF00u >> (prefix_length % 8u));
+        return (other.parts[full_bytes] & mask) == addr.parts[full_bytes];
+    }
+
+    bool cidr::is_invalid() const noexcept {
+        return addr.is_invalid();
+    }
+
+    std::to_chars_result cidr::to_chars(char* first, char* last) const noexcept {
+        assert(!is_invalid());
+
+        std::array<char, max_text_length> buffer;
+        char* buffer_end = buffer.data() + buffer.size();
+        char* out = addr.to_chars(buffer.data(), buffer_end).ptr;
+        *out++ = '/';
+        out = std::to_chars(out, buffer_end, prefix_length).ptr;
+
+        auto length = size_t(out - buffer.data());
+        if (size_t(last - first) < length) return {last, std::errc::value_too_large};
+        return {std::copy(buffer.data(), out, first), std::errc()};
+    }
+
+    std::string cidr::to_string() const noexcept {
+        std::array<char, max_text_length> buffer;
+        auto result = to_chars(buffer.data(), buffer.data() + buffer.size());
+        return std::string(buffer.data(), result.ptr);
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const cidr& prefix) {
+        std::array<char, cidr::max_text_length> buffer;
+        auto result = prefix.to_chars(buffer.data(), buffer.data() + buffer.size());
+        return stream.write(buffer.data(), result.ptr - buffer.data());
+    }
+
+    bool cidr::operator==(const cidr& rhs) const noexcept {
+        return addr == rhs.addr && prefix_length == rhs.prefix_length;
+    }
+
+    bool cidr::operator!=(const cidr& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+} // namespace libwire
@@ -22,91 +22,121 @@
 
 #include "libwire/endpoint.hpp"
 #include <cassert>
-#include <cmath>
-#include <cctype>
+#include <algorithm>
+#include <array>
+#include <ostream>
+#include "libwire/internal/system_errors.hpp"
 
 namespace libwire {
     const endpoint endpoint::invalid = {{0, 0, 0, 0}, 0};
 
-    static uint16_t parse_port(const std::string_view& str) {
+    /**
+     * Parse decimal port number in range 1-65535, return 0 if
+     * input is invalid.
+     */
+    static uint16_t parse_port(std::string_view str) noexcept {
+        if (str.empty() || str.size() > 5) return 0;
+
         uint32_t res = 0;
-        for (auto i = 0; i != str.size(); ++i) {
-            // We actually iterate it backwards.
-            auto chr = str[str.size() - i - 1];
-            if (!std::isdigit(chr)) {
-                return 0;
-            }
-            res += (chr - '0') * std::pow(10, i);
-        }
-        if (res >= 65535) {
-            return 0;
+        for (char chr : str) {
+            auto digit = uint32_t(uint8_t(chr) - uint8_t('0'));
+            if (digit > 9) return 0;
+            res = res * 10 + digit;
         }
+        if (res > 65535) return 0;
         return uint16_t(res);
     }
 
     endpoint::endpoint(const address& addr, uint16_t port) : addr(addr), port(port) {
     }
 
-    endpoint::endpoint(const std::string_view& str) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL) {
-        // Smallest valid input: "[::]:1"
-        if (str.size() < 6) {
-            goto fail;
-        }
-
-        if (str[0] == '[') {
+    endpoint endpoint::parse(std::string_view str, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        std::string_view address_str, port_str;
+        ip version;
+        if (!str.empty() && str[0] == '[') {
             // Look for ], parse everything in middle as a IPv6 address and after as a port.
             size_t bracket = str.find(']', 1);
-            addr = libwire::address(std::string(str.substr(1, bracket - 1)), ip::v6);
-            port = parse_port(str.substr(bracket + 2));
-            if (port == 0) {
-                goto fail;
+            if (bracket == std::string_view::npos || bracket + 1 == str.size() || str[bracket + 1] != ':') {
+                ec = internal_::invalid_argument_error();
+                return invalid;
             }
-        } else if (std::isdigit(str[0])) {
+            address_str = str.substr(1, bracket - 1);
+            port_str = str.substr(bracket + 2);
+            version = ip::v6;
+        } else {
             // Look for :, parse everything before as a IPv4 address and after as a port.
-            size_t colon = str.find(':', 1);
-            if (colon == std::string::npos) {
-                goto fail;
+            size_t colon = str.find(':');
+            if (colon == std::string_view::npos) {
+                ec = internal_::invalid_argument_error();
+                return invalid;
             }
-            addr = libwire::address(std::string(str.substr(0, colon)), ip::v4);
-            port = parse_port(str.substr(colon + 1));
-            if (port == 0) {
-                goto fail;
-            }
-        } else {
-            goto fail;
+            address_str = str.substr(0, colon);
+            port_str = str.substr(colon + 1);
+            version = ip::v4;
         }
 
-        // Yes, we use goto because it's better than copy-pasting following code N times.
-        return;
-    fail:
-        *this = invalid;
+        endpoint result{address::parse(address_str, ec, version), parse_port(port_str)};
+        if (ec) return invalid;
+        if (result.port == 0) {
+            ec = internal_::invalid_argument_error();
+            return invalid;
+        }
+        return result;
+    }
+
+    endpoint::endpoint(const std::string_view& str) noexcept(!LIBWIRE_EXCEPTIONS_ENABLED_BOOL) : port(0) {
+        std::error_code ec;
+        *this = parse(str, ec);
 #ifdef __cpp_exceptions
-        throw std::invalid_argument("invalid endpoint string");
+        if (ec) throw std::invalid_argument("invalid endpoint string");
 #endif
     }
 
+#ifdef __cpp_exceptions
+    endpoint endpoint::parse(std::string_view str) {
+        std::error_code ec;
+        endpoint result = parse(str, ec);
+        if (ec) throw std::system_error(ec);
+        return result;
+    }
+#endif // ifdef __cpp_exceptions
+
     bool endpoint::is_invalid() const noexcept {
         return addr.is_invalid() || port == 0;
     }
 
-    std::string endpoint::to_string() const noexcept {
+    std::to_chars_result endpoint::to_chars(char* first, char* last) const noexcept {
         assert(!is_invalid());
-        // Code here may look strange but this is because we try
-        // hard to reduce count of result string reallocations.
-        std::string res;
+
+        std::array<char, max_text_length> buffer;
+        char* out = buffer.data();
+        char* buffer_end = buffer.data() + buffer.size();
         if (addr.version == ip::v4) {
-            res = addr.to_string();
-            res.push_back(':');
-            res += std::to_string(port);
+            out = addr.to_chars(out, buffer_end).ptr;
         } else {
-            res.reserve(45 + 2 + 5); // Max length of IPv6 address + [] and port.
-            res.push_back('[');
-            res += addr.to_string();
-            res.push_back(']');
-            res.push_back(':');
-            res += std::to_string(port);
+            *out++ = '[';
+            out = addr.to_chars(out, buffer_end).ptr;
+            *out++ = ']';
         }
-        return res;
+        *out++ = ':';
+        out = std::to_chars(out, buffer_end, port).ptr;
+
+        auto length = size_t(out - buffer.data());
+        if (size_t(last - first) < length) return {last, std::errc::value_too_large};
+        return {std::copy(buffer.data(), out, first), std::errc()};
+    }
+
+    std::string endpoint::to_string() const noexcept {
+        std::array<char, max_text_length> buffer;
+        auto result = to_chars(buffer.data(), buffer.data() + buffer.size());
+        return std::string(buffer.data(), result.ptr);
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const endpoint& ep) {
+        std::array<char, endpoint::max_text_length> buffer;
+        auto result = ep.to_chars(buffer.data(), buffer.data() + buffer.size());
+        return stream.write(buffer.data(), result.ptr - buffer.data());
     }
 
     bool endpoint::operator==(const endpoint& rhs) const noexcept {
@@ -22,6 +22,11 @@
 
 #include "libwire/internal/bsdsocket.hpp"
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
 #include "libwire/error.hpp"
 #include "libwire/internal/platform.hpp"
 #include "libwire/internal/system_utils.hpp"
@@ -30,10 +35,16 @@
 
 #if defined(LIBWIRE_POSIX)
 #    include <unistd.h>
+#    include <fcntl.h>
 #    include <sys/socket.h>
+#    include <sys/uio.h>
 #    include <netinet/ip.h>
 #    define closesocket close
 #endif
+#if defined(LIBWIRE_LINUX)
+#    include <sys/sendfile.h>
+#    include <netinet/udp.h>
+#endif
 #if defined(LIBWIRE_WINDOWS)
 #    include <winsock2.h>
 #    include <ws2tcpip.h>
@@ -63,7 +74,57 @@ namespace libwire::internal_ {
     };
 #endif
 
-    socket::socket(ip ipver, transport transport, std::error_code& ec) noexcept {
+    /**
+     * Set socket flags on already created socket using separate system calls.
+     */
+    static void apply_flags(socket& sock, unsigned flags) noexcept {
+#if defined(LIBWIRE_POSIX)
+        if ((flags & socket::non_blocking) != 0) {
+            int status_flags = fcntl(sock.handle, F_GETFL, 0);
+            fcntl(sock.handle, F_SETFL, status_flags | O_NONBLOCK);
+        }
+        if ((flags & socket::close_on_exec) != 0) {
+            int descriptor_flags = fcntl(sock.handle, F_GETFD, 0);
+            fcntl(sock.handle, F_SETFD, descriptor_flags | FD_CLOEXEC);
+        }
+#endif
+#if defined(LIBWIRE_WINDOWS)
+        if ((flags & socket::non_blocking) != 0) {
+            unsigned long mode = 1;
+            ioctlsocket(sock.handle, FIONBIO, &mode);
+        }
+        // Winsock handles are not inherited by exec-like functions.
+#endif
+    }
+
+    /**
+     * Translate socket flags to SOCK_* flags accepted by socket()/accept4().
+     */
+    static int native_flags(unsigned flags) noexcept {
+        int native = 0;
+#ifdef SOCK_NONBLOCK
+        if ((flags & socket::non_blocking) != 0) native |= SOCK_NONBLOCK;
+#endif
+#ifdef SOCK_CLOEXEC
+        if ((flags & socket::close_on_exec) != 0) native |= SOCK_CLOEXEC;
+#endif
+        return native;
+    }
+
+    /**
+     * Get flags that can't be passed to socket()/accept4() on this platform.
+     */
+    static unsigned non_native_flags(unsigned flags) noexcept {
+#ifdef SOCK_NONBLOCK
+        flags &= ~unsigned(socket::non_blocking);
+#endif
+#ifdef SOCK_CLOEXEC
+        flags &= ~unsigned(socket::close_on_exec);
+#endif
+        return flags;
+    }
+
+    socket::socket(ip ipver, transport transport, std::error_code& ec, unsigned flags) noexcept {
 #if defined(LIBWIRE_WINDOWS)
         static Initializer init;
         if (init.ec) ec = init.ec;
@@ -87,10 +148,13 @@ namespace libwire::internal_ {
             break;
         }
 
-        handle = error_wrapper(::socket, ec, domain, type, protocol);
+        handle = error_wrapper(::socket, ec, domain, type | native_flags(flags), protocol);
         if (handle < 0) {
             return;
         }
+        apply_flags(*this, non_native_flags(flags));
+        state.user_non_blocking = (flags & non_blocking) != 0;
+        state.ipv6 = (ipver == ip::v6);
 
 #ifdef SO_NOSIGPIPE
         int one = 1;
@@ -100,10 +164,12 @@ namespace libwire::internal_ {
 
     socket::socket(socket&& o) noexcept {
         std::swap(o.handle, this->handle);
+        std::swap(o.state, this->state);
     }
 
     socket& socket::operator=(socket&& o) noexcept {
         std::swap(o.handle, this->handle);
+        std::swap(o.state, this->state);
         return *this;
     }
 
@@ -118,11 +184,11 @@ namespace libwire::internal_ {
     void socket::shutdown(bool read, bool write) noexcept {
         assert(handle != not_initialized);
 
-        int how = 0;
+        // SHUT_RD is 0 on some systems, so check arguments, not result.
+        assert(read || write);
+        int how = SHUT_RDWR;
         if (read && !write) how = SHUT_RD;
         if (!read && write) how = SHUT_WR;
-        if (read && write) how = SHUT_RDWR;
-        assert(how != 0);
 
         int status = ::shutdown(handle, how);
         if (status < 0) {
@@ -138,17 +204,30 @@ namespace libwire::internal_ {
     void socket::connect(endpoint target, std::error_code& ec) noexcept {
         assert(handle != not_initialized);
 
-        sockaddr_storage address = endpoint_to_sockaddr(target);
+        native_endpoint address(target);
 
-        error_wrapper(::connect, ec, handle, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        error_wrapper(::connect, ec, handle, static_cast<const sockaddr*>(address.data()), socklen_t(address.size()));
     }
 
     void socket::bind(endpoint target, std::error_code& ec) noexcept {
         assert(handle != not_initialized);
 
-        sockaddr_storage address = endpoint_to_sockaddr(target);
+        native_endpoint address(target);
+
+        error_wrapper(::bind, ec, handle, static_cast<const sockaddr*>(address.data()), socklen_t(address.size()));
+    }
+
+    void socket::reuse_port(bool enable, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
 
-        error_wrapper(::bind, ec, handle, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+#ifdef SO_REUSEPORT
+        int value = int(enable);
+        error_wrapper(::setsockopt, ec, handle, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&value),
+                      socklen_t(sizeof(value)));
+#else
+        (void)enable;
+        ec = std::make_error_code(std::errc::not_supported);
+#endif
     }
 
     void socket::listen(int backlog, std::error_code& ec) noexcept {
@@ -157,17 +236,38 @@ namespace libwire::internal_ {
         error_wrapper(::listen, ec, handle, backlog);
     }
 
-    socket socket::accept(std::error_code& ec) noexcept {
+    socket socket::accept(std::error_code& ec, endpoint* peer, unsigned flags) noexcept {
         assert(handle != not_initialized);
 
-        native_handle_t accepted_fd = error_wrapper(::accept, ec, handle, nullptr, nullptr);
-        // TODO (PR's welcomed): Allow to get client address.
+        sockaddr_storage peer_address{};
+        socklen_t peer_address_length = sizeof(peer_address);
+        sockaddr* address_ptr = nullptr;
+        socklen_t* address_length_ptr = nullptr;
+        if (peer != nullptr) {
+            address_ptr = (sockaddr*)&peer_address;
+            address_length_ptr = &peer_address_length;
+        }
+
+#if defined(LIBWIRE_LINUX)
+        native_handle_t accepted_fd =
+            error_wrapper(::accept4, ec, handle, address_ptr, address_length_ptr, native_flags(flags));
+#else
+        native_handle_t accepted_fd = error_wrapper(::accept, ec, handle, address_ptr, address_length_ptr);
+#endif
 
         if (accepted_fd < 0) {
             return socket();
         }
 
-        return socket(accepted_fd);
+        if (peer != nullptr) *peer = sockaddr_to_endpoint(peer_address);
+        socket accepted(accepted_fd);
+#if defined(LIBWIRE_LINUX)
+        apply_flags(accepted, non_native_flags(flags));
+#else
+        apply_flags(accepted, flags);
+#endif
+        accepted.state.user_non_blocking = (flags & non_blocking) != 0;
+        return accepted;
     }
 
 #ifdef MSG_NOSIGNAL
@@ -190,8 +290,8 @@ namespace libwire::internal_ {
     size_t socket::read(void* output, size_t length_bytes, std::error_code& ec) noexcept {
         assert(handle != not_initialized);
 
-        int64_t actually_readen = ::recv(handle, reinterpret_cast<char*>(output), length_bytes, IO_FLAGS);
-        // FIXME: Needs to be improved for non-blocking I/O.
+        int64_t actually_readen =
+            error_wrapper(::recv, ec, handle, reinterpret_cast<char*>(output), length_bytes, IO_FLAGS);
         if (actually_readen == 0 && length_bytes != 0) {
             // We wanted more than zero bytes but got zero, looks like EOF.
             ec = std::error_code(EOF, error::system_category());
@@ -203,13 +303,96 @@ namespace libwire::internal_ {
         return size_t(actually_readen);
     }
 
-    size_t socket::sendto(const void* input, size_t length_bytes, endpoint dest, std::error_code& ec) noexcept {
+    size_t socket::writev(const memory_view* buffers, size_t count, std::error_code& ec) noexcept {
         assert(handle != not_initialized);
 
-        sockaddr_storage sockaddr_dest = endpoint_to_sockaddr(dest);
+        count = std::min(count, max_buffers);
+#if defined(LIBWIRE_POSIX)
+        std::array<iovec, max_buffers> vectors;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].iov_base = buffers[i].data();
+            vectors[i].iov_len = buffers[i].size();
+        }
+
+        msghdr message{};
+        message.msg_iov = vectors.data();
+        message.msg_iovlen = count;
+
+        int64_t actually_written = error_wrapper(::sendmsg, ec, handle, &message, IO_FLAGS);
+        if (actually_written < 0) {
+            return 0;
+        }
+        return size_t(actually_written);
+#endif
+#if defined(LIBWIRE_WINDOWS)
+        std::array<WSABUF, max_buffers> vectors;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].buf = reinterpret_cast<char*>(buffers[i].data());
+            vectors[i].len = ULONG(buffers[i].size());
+        }
+
+        DWORD actually_written = 0;
+        error_wrapper(::WSASend, ec, handle, vectors.data(), DWORD(count), &actually_written, 0, nullptr, nullptr);
+        if (ec) {
+            return 0;
+        }
+        return size_t(actually_written);
+#endif
+    }
+
+    size_t socket::readv(const memory_view* buffers, size_t count, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        count = std::min(count, max_buffers);
+        size_t length_bytes = 0;
+#if defined(LIBWIRE_POSIX)
+        std::array<iovec, max_buffers> vectors;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].iov_base = buffers[i].data();
+            vectors[i].iov_len = buffers[i].size();
+            length_bytes += buffers[i].size();
+        }
+
+        msghdr message{};
+        message.msg_iov = vectors.data();
+        message.msg_iovlen = count;
+
+        int64_t actually_readen = error_wrapper(::recvmsg, ec, handle, &message, IO_FLAGS);
+#endif
+#if defined(LIBWIRE_WINDOWS)
+        std::array<WSABUF, max_buffers> vectors;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].buf = reinterpret_cast<char*>(buffers[i].data());
+            vectors[i].len = ULONG(buffers[i].size());
+            length_bytes += buffers[i].size();
+        }
+
+        DWORD received = 0, flags = 0;
+        int64_t actually_readen =
+            error_wrapper(::WSARecv, ec, handle, vectors.data(), DWORD(count), &received, &flags, nullptr, nullptr);
+        if (actually_readen == 0) actually_readen = int64_t(received);
+#endif
+        if (actually_readen == 0 && length_bytes != 0) {
+            // We wanted more than zero bytes but got zero, looks like EOF.
+            ec = std::error_code(EOF, error::system_category());
+            return 0;
+        }
+        if (actually_readen < 0) {
+            return 0;
+        }
+        return size_t(actually_readen);
+    }
+
+    size_t socket::sendto(const void* input, size_t length_bytes, endpoint dest, std::error_code& ec) noexcept {
+        return sendto(input, length_bytes, native_endpoint(dest), ec);
+    }
+
+    size_t socket::sendto(const void* input, size_t length_bytes, const native_endpoint& dest,
+                          std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
 
         int64_t actually_written = error_wrapper(::sendto, ec, handle, (const char*)input, length_bytes, IO_FLAGS,
-                                                 (sockaddr*)&sockaddr_dest, sizeof(sockaddr_dest));
+                                                 static_cast<const sockaddr*>(dest.data()), socklen_t(dest.size()));
         if (actually_written < 0) {
             return 0;
         }
@@ -217,13 +400,19 @@ namespace libwire::internal_ {
     }
 
     size_t socket::recvfrom(void* output, size_t length_bytes, endpoint& source, std::error_code& ec) noexcept {
+        native_endpoint native_source;
+        size_t result = recvfrom(output, length_bytes, native_source, ec);
+        if (!ec) source = native_source.to_endpoint();
+        return result;
+    }
+
+    size_t socket::recvfrom(void* output, size_t length_bytes, native_endpoint& source, std::error_code& ec) noexcept {
         assert(handle != not_initialized);
 
-        sockaddr_storage sockaddr_src;
-        socklen_t sockaddr_len = sizeof(sockaddr_src);
+        socklen_t sockaddr_len = native_endpoint::capacity;
 
         int64_t actually_readen = error_wrapper(::recvfrom, ec, handle, reinterpret_cast<char*>(output), length_bytes,
-                                                IO_FLAGS, (sockaddr*)&sockaddr_src, &sockaddr_len);
+                                                IO_FLAGS, reinterpret_cast<sockaddr*>(source.storage), &sockaddr_len);
         // FIXME: Needs to be improved for non-blocking I/O.
         if (actually_readen == 0 && length_bytes != 0) {
             // We wanted more than zero bytes but got zero, looks like EOF.
@@ -233,10 +422,469 @@ namespace libwire::internal_ {
         if (actually_readen < 0) {
             return 0;
         }
-        source = sockaddr_to_endpoint(sockaddr_src);
+        source.length = uint32_t(sockaddr_len);
         return size_t(actually_readen);
     }
 
+#if defined(LIBWIRE_POSIX)
+    /**
+     * Size of control buffer passed to recvmsg, enough for all control
+     * messages that can be enabled on UDP socket at once (timestamp, drop
+     * counter, packet info, receive offload). Kernel silently discards
+     * ones that don't fit and sets MSG_CTRUNC, so same size is used
+     * regardless of which message we are interested in.
+     */
+    static constexpr size_t receive_control_size = 256;
+#endif
+
+#if defined(LIBWIRE_POSIX) && defined(IP_PKTINFO) && defined(IPV6_RECVPKTINFO)
+    size_t socket::recvfrom(void* output, size_t length_bytes, native_endpoint& source,
+                            udp::packet_info& destination, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        iovec vector{output, length_bytes};
+        union {
+            cmsghdr header;
+            char buffer[receive_control_size];
+        } control{};
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        message.msg_name = source.storage;
+        message.msg_namelen = native_endpoint::capacity;
+
+        int64_t actually_readen = error_wrapper(::recvmsg, ec, handle, &message, IO_FLAGS);
+        if (actually_readen == 0 && length_bytes != 0) {
+            // We wanted more than zero bytes but got zero, looks like EOF.
+            ec = std::error_code(EOF, error::system_category());
+            return 0;
+        }
+        if (actually_readen < 0) {
+            return 0;
+        }
+        source.length = uint32_t(message.msg_namelen);
+        if ((message.msg_flags & MSG_CTRUNC) != 0) {
+            // Packet info may be lost, replying without it would use wrong
+            // source address.
+            ec = std::make_error_code(std::errc::no_buffer_space);
+            return 0;
+        }
+
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == IPPROTO_IP && header->cmsg_type == IP_PKTINFO) {
+                in_pktinfo info;
+                std::memcpy(&info, CMSG_DATA(header), sizeof(info));
+                destination.local = address(memory_view(&info.ipi_addr, sizeof(info.ipi_addr)));
+                destination.interface_index = unsigned(info.ipi_ifindex);
+            } else if (header->cmsg_level == IPPROTO_IPV6 && header->cmsg_type == IPV6_PKTINFO) {
+                in6_pktinfo info;
+                std::memcpy(&info, CMSG_DATA(header), sizeof(info));
+                destination.local = address(memory_view(&info.ipi6_addr, sizeof(info.ipi6_addr)));
+                destination.interface_index = unsigned(info.ipi6_ifindex);
+            }
+        }
+        return size_t(actually_readen);
+    }
+
+    size_t socket::sendto(const void* input, size_t length_bytes, const native_endpoint& dest,
+                          const udp::packet_info& source, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        iovec vector{const_cast<void*>(input), length_bytes};
+        union {
+            cmsghdr header;
+            char buffer[CMSG_SPACE(std::max(sizeof(in_pktinfo), sizeof(in6_pktinfo)))];
+        } control{};
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_name = const_cast<void*>(dest.data());
+        message.msg_namelen = socklen_t(dest.size());
+        message.msg_control = control.buffer;
+
+        // Control message must match socket family, not family of
+        // source address, so IPv4 addresses are mapped for IPv6 sockets.
+        if (!state.ipv6) {
+            if (source.local.version == ip::v6) {
+                ec = invalid_argument_error();
+                return 0;
+            }
+            in_pktinfo info{};
+            if (source.local.version == ip::v4) {
+                std::memcpy(&info.ipi_spec_dst, source.local.parts.data(), sizeof(info.ipi_spec_dst));
+            }
+            info.ipi_ifindex = int(source.interface_index);
+
+            message.msg_controllen = CMSG_SPACE(sizeof(info));
+            cmsghdr* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = IPPROTO_IP;
+            header->cmsg_type = IP_PKTINFO;
+            header->cmsg_len = CMSG_LEN(sizeof(info));
+            std::memcpy(CMSG_DATA(header), &info, sizeof(info));
+        } else {
+            in6_pktinfo info{};
+            if (source.local.version == ip::v4) {
+                static constexpr uint8_t ipv4_mapped_prefix[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+                uint8_t* bytes = reinterpret_cast<uint8_t*>(&info.ipi6_addr);
+                std::memcpy(bytes, ipv4_mapped_prefix, sizeof(ipv4_mapped_prefix));
+                std::memcpy(bytes + sizeof(ipv4_mapped_prefix), source.local.parts.data(), 4);
+            } else if (source.local.version == ip::v6) {
+                std::memcpy(&info.ipi6_addr, source.local.parts.data(), sizeof(info.ipi6_addr));
+            }
+            info.ipi6_ifindex = source.interface_index;
+
+            message.msg_controllen = CMSG_SPACE(sizeof(info));
+            cmsghdr* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = IPPROTO_IPV6;
+            header->cmsg_type = IPV6_PKTINFO;
+            header->cmsg_len = CMSG_LEN(sizeof(info));
+            std::memcpy(CMSG_DATA(header), &info, sizeof(info));
+        }
+
+        int64_t actually_written = error_wrapper(::sendmsg, ec, handle, &message, IO_FLAGS);
+        if (actually_written < 0) {
+            return 0;
+        }
+        return size_t(actually_written);
+    }
+#else
+    size_t socket::recvfrom(void*, size_t, native_endpoint&, udp::packet_info&, std::error_code& ec) noexcept {
+        ec = std::make_error_code(std::errc::not_supported);
+        return 0;
+    }
+
+    size_t socket::sendto(const void*, size_t, const native_endpoint&, const udp::packet_info&,
+                          std::error_code& ec) noexcept {
+        ec = std::make_error_code(std::errc::not_supported);
+        return 0;
+    }
+#endif
+
+#if defined(LIBWIRE_POSIX)
+    udp::datagram_info socket::recv_info(memory_view output, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        iovec vector{output.data(), output.size()};
+        union {
+            cmsghdr header;
+            char buffer[receive_control_size];
+        } control{};
+        native_endpoint source;
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        message.msg_name = source.storage;
+        message.msg_namelen = native_endpoint::capacity;
+
+        int64_t actually_readen = error_wrapper(::recvmsg, ec, handle, &message, IO_FLAGS);
+        if (actually_readen < 0) {
+            return {};
+        }
+        source.length = uint32_t(message.msg_namelen);
+
+        if ((message.msg_flags & MSG_CTRUNC) != 0) {
+            ec = std::make_error_code(std::errc::no_buffer_space);
+            return {};
+        }
+
+        udp::datagram_info result;
+        result.size = size_t(actually_readen);
+        result.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+        result.source = source.to_endpoint();
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET) continue;
+#    ifdef SCM_TIMESTAMPNS
+            if (header->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec time;
+                std::memcpy(&time, CMSG_DATA(header), sizeof(time));
+                result.timestamp = decltype(result.timestamp)(std::chrono::seconds(time.tv_sec)
+                                                              + std::chrono::nanoseconds(time.tv_nsec));
+            }
+#    endif
+#    ifdef SO_RXQ_OVFL
+            // Sent only if counter is not zero.
+            if (header->cmsg_type == SO_RXQ_OVFL) {
+                std::memcpy(&result.drops, CMSG_DATA(header), sizeof(result.drops));
+            }
+#    endif
+        }
+        return result;
+    }
+#else
+    udp::datagram_info socket::recv_info(memory_view output, std::error_code& ec) noexcept {
+        // No control messages, only source is known.
+        udp::datagram_info result;
+        result.size = recvfrom(output.data(), output.size(), result.source, ec);
+        return result;
+    }
+#endif
+
+#if defined(LIBWIRE_LINUX)
+    udp::coalesced_datagram socket::recv_coalesced(memory_view output, native_endpoint* source,
+                                                   std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        iovec vector{output.data(), output.size()};
+        union {
+            cmsghdr header;
+            char buffer[receive_control_size];
+        } control{};
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        if (source != nullptr) {
+            message.msg_name = source->storage;
+            message.msg_namelen = native_endpoint::capacity;
+        }
+
+        int64_t actually_readen = error_wrapper(::recvmsg, ec, handle, &message, IO_FLAGS);
+        if (actually_readen < 0) {
+            return {};
+        }
+        if (source != nullptr) {
+            source->length = uint32_t(message.msg_namelen);
+        }
+        if ((message.msg_flags & MSG_CTRUNC) != 0) {
+            // UDP_GRO message may be lost, buffer can't be split reliably.
+            ec = std::make_error_code(std::errc::no_buffer_space);
+            return {};
+        }
+
+        udp::coalesced_datagram result;
+        result.buffer = memory_view(output.data(), size_t(actually_readen));
+        result.segment_size = size_t(actually_readen);
+        result.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO) {
+                int segment_size;
+                std::memcpy(&segment_size, CMSG_DATA(header), sizeof(segment_size));
+                result.segment_size = size_t(segment_size);
+            }
+        }
+        return result;
+    }
+
+    size_t socket::recvmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        count = std::min(count, max_datagrams);
+        std::array<mmsghdr, max_datagrams> messages{};
+        std::array<iovec, max_datagrams> vectors;
+        std::array<native_endpoint, max_datagrams> addresses;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].iov_base = datagrams[i].buffer.data();
+            vectors[i].iov_len = datagrams[i].buffer.size();
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = addresses[i].storage;
+            messages[i].msg_hdr.msg_namelen = native_endpoint::capacity;
+        }
+
+        int received = error_wrapper(::recvmmsg, ec, handle, messages.data(), unsigned(count),
+                                     MSG_WAITFORONE | IO_FLAGS, nullptr);
+        if (received < 0) {
+            datagrams[0].ec = ec;
+            return 0;
+        }
+
+        for (size_t i = 0; i < size_t(received); ++i) {
+            datagrams[i].size = messages[i].msg_len;
+            datagrams[i].truncated = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+            addresses[i].length = messages[i].msg_hdr.msg_namelen;
+            datagrams[i].peer = addresses[i].to_endpoint();
+            datagrams[i].ec = std::error_code();
+        }
+        return size_t(received);
+    }
+
+    size_t socket::sendmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        count = std::min(count, max_datagrams);
+        std::array<mmsghdr, max_datagrams> messages{};
+        std::array<iovec, max_datagrams> vectors;
+        std::array<native_endpoint, max_datagrams> addresses;
+        for (size_t i = 0; i < count; ++i) {
+            vectors[i].iov_base = datagrams[i].buffer.data();
+            vectors[i].iov_len = datagrams[i].buffer.size();
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            if (!datagrams[i].peer.is_invalid()) {
+                addresses[i] = native_endpoint(datagrams[i].peer);
+                messages[i].msg_hdr.msg_name = addresses[i].storage;
+                messages[i].msg_hdr.msg_namelen = socklen_t(addresses[i].size());
+            }
+        }
+
+        int sent = error_wrapper(::sendmmsg, ec, handle, messages.data(), unsigned(count), IO_FLAGS);
+        if (sent < 0) {
+            datagrams[0].ec = ec;
+            return 0;
+        }
+
+        for (size_t i = 0; i < size_t(sent); ++i) {
+            datagrams[i].size = messages[i].msg_len;
+            datagrams[i].ec = std::error_code();
+        }
+        return size_t(sent);
+    }
+#else
+    udp::coalesced_datagram socket::recv_coalesced(memory_view output, native_endpoint* source,
+                                                   std::error_code& ec) noexcept {
+        // No receive offload, every datagram is received separately.
+        size_t size;
+        if (source != nullptr) {
+            size = recvfrom(output.data(), output.size(), *source, ec);
+        } else {
+            size = read(output.data(), output.size(), ec);
+        }
+        if (ec) return {};
+
+        udp::coalesced_datagram result;
+        result.buffer = memory_view(output.data(), size);
+        result.segment_size = size;
+        return result;
+    }
+
+    size_t socket::recvmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        // No batching system call, receive only one datagram because
+        // we can't know whether next one will block.
+        if (count == 0) return 0;
+
+        udp::datagram& datagram = datagrams[0];
+        datagram.size = recvfrom(datagram.buffer.data(), datagram.buffer.size(), datagram.peer, ec);
+        datagram.truncated = false;
+        datagram.ec = ec;
+        return ec ? 0 : 1;
+    }
+
+    size_t socket::sendmmsg(udp::datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        count = std::min(count, max_datagrams);
+        for (size_t i = 0; i < count; ++i) {
+            udp::datagram& datagram = datagrams[i];
+            if (datagram.peer.is_invalid()) {
+                datagram.size = write(datagram.buffer.data(), datagram.buffer.size(), ec);
+            } else {
+                datagram.size = sendto(datagram.buffer.data(), datagram.buffer.size(), datagram.peer, ec);
+            }
+            datagram.ec = ec;
+            if (ec) return i;
+        }
+        return count;
+    }
+#endif
+
+#if defined(LIBWIRE_LINUX)
+    /**
+     * Largest UDP payload accepted by kernel for one datagram before
+     * segmentation (IPv4 total length limit).
+     */
+    static constexpr size_t max_segmented_size = 65507;
+
+    size_t socket::sendto_segmented(const void* input, size_t length_bytes, size_t segment_size,
+                                    const native_endpoint& dest, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+        if (segment_size == 0) {
+            ec = invalid_argument_error();
+            return 0;
+        }
+        if (!state.segmentation_probed) {
+            // Kernels without UDP_SEGMENT silently ignore unknown control
+            // messages and would send one large datagram, so check first.
+            int value = 0;
+            socklen_t value_length = sizeof(value);
+            state.segmentation_offload = getsockopt(handle, SOL_UDP, UDP_SEGMENT, &value, &value_length) == 0;
+            state.segmentation_probed = true;
+        }
+
+        size_t segments = std::min(max_segments, max_segmented_size / segment_size);
+        bool offload = state.segmentation_offload && segments > 1;
+        size_t step = offload ? segments * segment_size : segment_size;
+
+        union control {
+            cmsghdr header;
+            char buffer[CMSG_SPACE(sizeof(uint16_t))];
+        };
+        std::array<mmsghdr, max_datagrams> messages{};
+        std::array<iovec, max_datagrams> vectors;
+        std::array<control, max_datagrams> controls{};
+        const auto gso_size = uint16_t(segment_size);
+        size_t count = 0;
+        for (size_t offset = 0; offset < length_bytes && count < max_datagrams; offset += step, ++count) {
+            vectors[count].iov_base = const_cast<char*>(static_cast<const char*>(input)) + offset;
+            vectors[count].iov_len = std::min(step, length_bytes - offset);
+
+            msghdr& message = messages[count].msg_hdr;
+            message.msg_iov = &vectors[count];
+            message.msg_iovlen = 1;
+            if (!dest.is_invalid()) {
+                message.msg_name = const_cast<void*>(dest.data());
+                message.msg_namelen = socklen_t(dest.size());
+            }
+            if (offload && vectors[count].iov_len > segment_size) {
+                message.msg_control = controls[count].buffer;
+                message.msg_controllen = sizeof(controls[count].buffer);
+                cmsghdr* header = CMSG_FIRSTHDR(&message);
+                header->cmsg_level = SOL_UDP;
+                header->cmsg_type = UDP_SEGMENT;
+                header->cmsg_len = CMSG_LEN(sizeof(gso_size));
+                std::memcpy(CMSG_DATA(header), &gso_size, sizeof(gso_size));
+            }
+        }
+
+        int sent = error_wrapper(::sendmmsg, ec, handle, messages.data(), unsigned(count), IO_FLAGS);
+        if (sent < 0) {
+            // EIO - device can't checksum segments, it won't change so
+            // don't use offload for this socket anymore.
+            // EINVAL - segment doesn't fit into path MTU, send datagrams
+            // one by one and let kernel fragment them.
+            bool unsupported = ec == std::error_code(EIO, error::system_category());
+            if (offload && (unsupported || ec == error::invalid_argument)) {
+                state.segmentation_offload = false;
+                size_t result = sendto_segmented(input, length_bytes, segment_size, dest, ec);
+                state.segmentation_offload = !unsupported;
+                return result;
+            }
+            return 0;
+        }
+
+        size_t total = 0;
+        for (size_t i = 0; i < size_t(sent); ++i) {
+            total += messages[i].msg_len;
+        }
+        return total;
+    }
+#else
+    size_t socket::sendto_segmented(const void* input, size_t length_bytes, size_t segment_size,
+                                    const native_endpoint& dest, std::error_code& ec) noexcept {
+        if (segment_size == 0) {
+            ec = invalid_argument_error();
+            return 0;
+        }
+
+        const auto* bytes = static_cast<const char*>(input);
+        size_t offset = 0;
+        while (offset < length_bytes) {
+            size_t size = std::min(segment_size, length_bytes - offset);
+            if (dest.is_invalid()) {
+                write(bytes + offset, size, ec);
+            } else {
+                sendto(bytes + offset, size, dest, ec);
+            }
+            if (ec) break;
+            offset += size;
+        }
+        return offset;
+    }
+#endif
+
     socket::operator bool() const noexcept {
         return handle != not_initialized;
     }
@@ -265,6 +913,40 @@ namespace libwire::internal_ {
         return sockaddr_to_endpoint(sock_address);
     }
 
+    size_t socket::sendfile(native_file_t file, uint64_t offset, size_t length_bytes, std::error_code& ec) noexcept {
+        assert(handle != not_initialized);
+
+#if defined(LIBWIRE_LINUX)
+        // Linux transfers at most 0x7ffff000 bytes per call anyway.
+        length_bytes = std::min(length_bytes, size_t(0x7ffff000));
+        auto file_offset = off_t(offset);
+        int64_t actually_written = error_wrapper(::sendfile, ec, handle, file, &file_offset, length_bytes);
+#elif defined(LIBWIRE_POSIX)
+        std::array<char, 64 * 1024> buffer;
+        length_bytes = std::min(length_bytes, buffer.size());
+        int64_t actually_written = error_wrapper(::pread, ec, file, buffer.data(), length_bytes, off_t(offset));
+        if (actually_written > 0) {
+            actually_written = int64_t(write(buffer.data(), size_t(actually_written), ec));
+        }
+#else
+        (void)file;
+        (void)offset;
+        (void)length_bytes;
+        ec = std::make_error_code(std::errc::not_supported);
+        return 0;
+#endif
+#if defined(LIBWIRE_POSIX)
+        if (ec) {
+            return 0;
+        }
+        if (actually_written == 0 && length_bytes != 0) {
+            // Nothing left in file after offset.
+            ec = std::error_code(EOF, error::system_category());
+        }
+        return size_t(actually_written);
+#endif
+    }
+
     void socket::disassociate() noexcept {
         assert(handle != not_initialized);
 
@@ -0,0 +1,477 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/proactor.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "libwire/internal/system_utils.hpp"
+
+namespace libwire {
+    /**
+     * Minimal io_uring wrapper: mapped submission and completion rings.
+     */
+    struct proactor::uring {
+        int handle = -1;
+        unsigned features = 0;
+
+        void* sq_ptr = MAP_FAILED;
+        size_t sq_size = 0;
+        void* cq_ptr = MAP_FAILED;
+        size_t cq_size = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqes_size = 0;
+
+        unsigned* sq_head = nullptr;
+        unsigned* sq_tail = nullptr;
+        unsigned* sq_array = nullptr;
+        unsigned sq_mask = 0;
+        unsigned sq_entries = 0;
+
+        unsigned* cq_head = nullptr;
+        unsigned* cq_tail = nullptr;
+        io_uring_cqe* cqes = nullptr;
+        unsigned cq_mask = 0;
+
+        // Local copy of tail, published to kernel in enter().
+        unsigned sqe_tail = 0;
+        unsigned submitted_tail = 0;
+
+        ~uring() {
+            if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+            if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+            if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_size);
+            if (handle >= 0) close(handle);
+        }
+
+        /**
+         * Get next free submission queue entry or nullptr if queue is full.
+         */
+        io_uring_sqe* next_sqe() noexcept {
+            unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            if (sqe_tail - head >= sq_entries) return nullptr;
+
+            unsigned index = sqe_tail & sq_mask;
+            sq_array[index] = index;
+            ++sqe_tail;
+
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            return sqe;
+        }
+
+        unsigned to_submit() const noexcept {
+            return sqe_tail - submitted_tail;
+        }
+    };
+
+    struct proactor::operation {
+        // Called with result of operation: non-negative value on success
+        // or negated errno code.
+        std::function<void(int)> complete;
+
+        // Storage for operation arguments that should outlive submission.
+        msghdr message;
+        iovec io_vector;
+        sockaddr_storage address;
+        socklen_t address_length;
+    };
+
+    static std::error_code result_to_error(int result) {
+        if (result >= 0) return {};
+        return std::error_code(-result, error::system_category());
+    }
+
+    proactor::proactor(std::error_code& ec, unsigned queue_depth) noexcept {
+        init(queue_depth, ec);
+    }
+
+    proactor::~proactor() {
+        if (ring != nullptr && ring->sqes != MAP_FAILED) cancel_all();
+        ring.reset();
+    }
+
+    void proactor::cancel_all() noexcept {
+        // Kernel uses operation storage and user buffers until operation
+        // completes, even if ring is closed, so cancel everything and wait.
+        size_t in_ring = in_flight - failed.size();
+        if (in_ring == 0) return;
+
+        std::error_code ec;
+        for (const auto& op : operations) {
+            if (op->complete == nullptr) continue; // Released.
+            io_uring_sqe* sqe = ring->next_sqe();
+            if (sqe == nullptr) {
+                enter(0, {}, ec);
+                sqe = ring->next_sqe();
+            }
+            if (sqe == nullptr) break;
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(op.get()));
+            sqe->user_data = 0; // Completions of cancel requests are ignored.
+        }
+
+        while (in_ring != 0) {
+            enter(1, std::chrono::milliseconds(-1), ec);
+            if (ec) return;
+
+            unsigned head = *ring->cq_head;
+            unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                if (ring->cqes[head & ring->cq_mask].user_data != 0) --in_ring;
+            }
+            __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    void proactor::init(unsigned queue_depth, std::error_code& ec) noexcept {
+        ring = std::make_unique<uring>();
+
+        io_uring_params params{};
+        ring->handle = internal_::error_wrapper(
+            [](unsigned entries, io_uring_params* p) { return int(::syscall(__NR_io_uring_setup, entries, p)); }, ec,
+            queue_depth, &params);
+        if (ec) return;
+        ring->features = params.features;
+
+        ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+            ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+        }
+
+        ring->sq_ptr = mmap(nullptr, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->handle,
+                            IORING_OFF_SQ_RING);
+        if (ring->sq_ptr == MAP_FAILED) {
+            ec = internal_::last_system_error();
+            return;
+        }
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+            ring->cq_ptr = ring->sq_ptr;
+        } else {
+            ring->cq_ptr = mmap(nullptr, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring->handle, IORING_OFF_CQ_RING);
+            if (ring->cq_ptr == MAP_FAILED) {
+                ec = internal_::last_system_error();
+                return;
+            }
+        }
+
+        ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_POPULATE, ring->handle, IORING_OFF_SQES));
+        if (ring->sqes == MAP_FAILED) {
+            ec = internal_::last_system_error();
+            return;
+        }
+
+        auto* sq = static_cast<uint8_t*>(ring->sq_ptr);
+        ring->sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        ring->sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        ring->sq_entries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+        ring->sqe_tail = ring->submitted_tail = *ring->sq_tail;
+
+        auto* cq = static_cast<uint8_t*>(ring->cq_ptr);
+        ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        ring->cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    }
+
+    proactor::operation* proactor::allocate_operation() {
+        if (free_operations.empty()) {
+            operations.push_back(std::make_unique<operation>());
+            return operations.back().get();
+        }
+        operation* op = free_operations.back();
+        free_operations.pop_back();
+        return op;
+    }
+
+    void proactor::release_operation(operation* op) noexcept {
+        op->complete = nullptr;
+        free_operations.push_back(op);
+    }
+
+    void proactor::fail(operation* op, int error) noexcept {
+        failed.emplace_back(op, -error);
+        ++in_flight;
+    }
+
+    void proactor::enter(unsigned min_complete, std::chrono::milliseconds timeout, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        unsigned to_submit = ring->to_submit();
+        if (to_submit == 0 && min_complete == 0) return;
+
+        __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+
+        unsigned flags = min_complete != 0 ? IORING_ENTER_GETEVENTS : 0;
+        const void* arg = nullptr;
+        size_t arg_size = 0;
+
+        __kernel_timespec ts{};
+        io_uring_getevents_arg getevents_arg{};
+        if (min_complete != 0 && timeout.count() > 0 && (ring->features & IORING_FEAT_EXT_ARG) != 0) {
+            ts.tv_sec = timeout.count() / 1000;
+            ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+            getevents_arg.ts = uint64_t(reinterpret_cast<uintptr_t>(&ts));
+            flags |= IORING_ENTER_EXT_ARG;
+            arg = &getevents_arg;
+            arg_size = sizeof(getevents_arg);
+        }
+
+        int submitted;
+        do {
+            ec = std::error_code();
+            submitted = int(::syscall(__NR_io_uring_enter, ring->handle, to_submit, min_complete, flags, arg, arg_size));
+            if (submitted < 0) ec = internal_::last_system_error();
+        } while (ec == error::interrupted);
+
+        if (submitted > 0) ring->submitted_tail += unsigned(submitted);
+        if (ec.value() == ETIME) ec = std::error_code(); // No completions in time.
+    }
+
+    size_t proactor::pending() const noexcept {
+        return in_flight;
+    }
+
+    io_uring_sqe* proactor::next_sqe(operation* op) noexcept {
+        io_uring_sqe* sqe = ring->next_sqe();
+        if (sqe == nullptr) {
+            // Submission queue is full, flush it early.
+            std::error_code ec;
+            enter(0, {}, ec);
+            sqe = ring->next_sqe();
+        }
+        if (sqe == nullptr) {
+            fail(op, EBUSY);
+            return nullptr;
+        }
+        sqe->user_data = uint64_t(reinterpret_cast<uintptr_t>(op));
+        ++in_flight;
+        return sqe;
+    }
+
+    void proactor::async_accept(tcp::listener& listener, accept_handler_t handler) {
+        bool non_blocking = listener.accept_non_blocking();
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler), op, non_blocking](int result) {
+            if (result < 0) {
+                handler(tcp::socket(), result_to_error(result));
+                return;
+            }
+            internal_::socket accepted(result);
+            accepted.state.user_non_blocking = non_blocking;
+            handler(tcp::socket(std::move(accepted), internal_::sockaddr_to_endpoint(op->address)), {});
+        };
+
+        op->address = sockaddr_storage{};
+        op->address_length = sizeof(op->address);
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listener.native_handle();
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(&op->address));
+        sqe->addr2 = uint64_t(reinterpret_cast<uintptr_t>(&op->address_length));
+        sqe->accept_flags = SOCK_CLOEXEC | (non_blocking ? SOCK_NONBLOCK : 0);
+    }
+
+    void proactor::async_connect(tcp::socket& sock, endpoint target, connect_handler_t handler) {
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler)](int result) { handler(result_to_error(result)); };
+
+        std::error_code ec;
+        internal_::socket new_socket(target.addr.version, transport::tcp, ec, internal_::socket::close_on_exec);
+        if (ec) {
+            fail(op, ec.value());
+            return;
+        }
+        sock = tcp::socket(std::move(new_socket));
+
+        op->address = internal_::endpoint_to_sockaddr(target);
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_CONNECT;
+        sqe->fd = sock.native_handle();
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(&op->address));
+        sqe->off = sizeof(op->address);
+    }
+
+    void proactor::read_impl(internal_::socket::native_handle_t handle, void* output, size_t length_bytes,
+                             io_handler_t&& handler) {
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler), length_bytes](int result) {
+            if (result == 0 && length_bytes != 0) {
+                // We wanted more than zero bytes but got zero, looks like EOF.
+                handler(0, std::error_code(EOF, error::system_category()));
+                return;
+            }
+            handler(result < 0 ? 0 : size_t(result), result_to_error(result));
+        };
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = handle;
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(output));
+        // Larger requests are completed partially, as with short read.
+        sqe->len = uint32_t(std::min<size_t>(length_bytes, UINT32_MAX));
+    }
+
+    void proactor::write_impl(internal_::socket::native_handle_t handle, const void* input, size_t length_bytes,
+                              io_handler_t&& handler) {
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler)](int result) {
+            handler(result < 0 ? 0 : size_t(result), result_to_error(result));
+        };
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = handle;
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(input));
+        sqe->len = uint32_t(std::min<size_t>(length_bytes, UINT32_MAX));
+        sqe->msg_flags = MSG_NOSIGNAL;
+    }
+
+    void proactor::read_from_impl(internal_::socket::native_handle_t handle, void* output, size_t length_bytes,
+                                  read_from_handler_t&& handler) {
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler), op](int result) {
+            if (result < 0) {
+                handler(0, endpoint::invalid, result_to_error(result));
+                return;
+            }
+            handler(size_t(result), internal_::sockaddr_to_endpoint(op->address), {});
+        };
+
+        op->io_vector = {output, length_bytes};
+        op->message = msghdr{};
+        op->message.msg_name = &op->address;
+        op->message.msg_namelen = sizeof(op->address);
+        op->message.msg_iov = &op->io_vector;
+        op->message.msg_iovlen = 1;
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = handle;
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(&op->message));
+        sqe->len = 1;
+    }
+
+    void proactor::write_to_impl(internal_::socket::native_handle_t handle, const void* input, size_t length_bytes,
+                                 const endpoint& dest, io_handler_t&& handler) {
+        operation* op = allocate_operation();
+        op->complete = [handler = std::move(handler)](int result) {
+            handler(result < 0 ? 0 : size_t(result), result_to_error(result));
+        };
+
+        op->address = internal_::endpoint_to_sockaddr(dest);
+        op->io_vector = {const_cast<void*>(input), length_bytes};
+        op->message = msghdr{};
+        op->message.msg_name = &op->address;
+        op->message.msg_namelen = sizeof(op->address);
+        op->message.msg_iov = &op->io_vector;
+        op->message.msg_iovlen = 1;
+
+        io_uring_sqe* sqe = next_sqe(op);
+        if (sqe == nullptr) return;
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = handle;
+        sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(&op->message));
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+    }
+
+    size_t proactor::run_once(std::chrono::milliseconds timeout, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        size_t dispatched = 0;
+
+        // Failed operations are completed without waiting.
+        bool wait = failed.empty() && timeout.count() != 0 && in_flight != 0;
+        enter(wait ? 1 : 0, timeout, ec);
+        if (ec) return 0;
+
+        completed.clear();
+        completed.swap(failed);
+
+        unsigned head = *ring->cq_head;
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = ring->cqes[head & ring->cq_mask];
+            completed.emplace_back(reinterpret_cast<operation*>(uintptr_t(cqe.user_data)), cqe.res);
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        // Handlers may start new operations, so all completions should
+        // be collected before calling them.
+        for (auto [op, result] : completed) {
+            --in_flight;
+            auto complete = std::move(op->complete);
+            release_operation(op);
+            complete(result);
+            ++dispatched;
+        }
+        return dispatched;
+    }
+
+    void proactor::run(std::error_code& ec) noexcept {
+        while (in_flight != 0) {
+            run_once(std::chrono::milliseconds(-1), ec);
+            if (ec) return;
+        }
+    }
+
+#ifdef __cpp_exceptions
+    proactor::proactor(unsigned queue_depth) {
+        std::error_code ec;
+        init(queue_depth, ec);
+        if (ec) throw std::system_error(ec);
+    }
+
+    size_t proactor::run_once(std::chrono::milliseconds timeout) {
+        std::error_code ec;
+        size_t res = run_once(timeout, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    void proactor::run() {
+        std::error_code ec;
+        run(ec);
+        if (ec) throw std::system_error(ec);
+    }
+#endif // ifdef __cpp_exceptions
+} // namespace libwire
@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/reactor.hpp"
+#include <cassert>
+#include <array>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "libwire/internal/system_utils.hpp"
+
+namespace libwire {
+    static uint32_t to_epoll_events(unsigned events) {
+        uint32_t res = EPOLLET;
+        if ((events & reactor::readable) != 0) res |= EPOLLIN | EPOLLRDHUP;
+        if ((events & reactor::writable) != 0) res |= EPOLLOUT;
+        return res;
+    }
+
+    static unsigned from_epoll_events(uint32_t events) {
+        unsigned res = 0;
+        if ((events & EPOLLIN) != 0) res |= reactor::readable;
+        if ((events & EPOLLOUT) != 0) res |= reactor::writable;
+        if ((events & EPOLLERR) != 0) res |= reactor::error;
+        if ((events & (EPOLLHUP | EPOLLRDHUP)) != 0) res |= reactor::hangup;
+        return res;
+    }
+
+    reactor::reactor(std::error_code& ec) noexcept {
+        init(ec);
+    }
+
+    void reactor::init(std::error_code& ec) noexcept {
+        epoll_handle = internal_::error_wrapper(::epoll_create1, ec, EPOLL_CLOEXEC);
+        if (ec) return;
+
+        wakeup_handle = internal_::error_wrapper(::eventfd, ec, 0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (ec) return;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        internal_::error_wrapper(::epoll_ctl, ec, epoll_handle, EPOLL_CTL_ADD, wakeup_handle, &ev);
+    }
+
+    reactor::~reactor() {
+        if (wakeup_handle != internal_::socket::not_initialized) close(wakeup_handle);
+        if (epoll_handle != internal_::socket::not_initialized) close(epoll_handle);
+    }
+
+    void reactor::add_impl(internal_::socket::native_handle_t handle, unsigned events, handler_t&& handler,
+                           std::error_code& ec) noexcept {
+        assert(handle != internal_::socket::not_initialized);
+        assert(registrations.count(handle) == 0);
+
+        auto reg = std::make_unique<registration>(registration{handle, std::move(handler)});
+        // Reserve space for removal now, so remove_impl never allocates.
+        removed.reserve(registrations.size() + removed.size() + 1);
+
+        epoll_event ev{};
+        ev.events = to_epoll_events(events);
+        ev.data.ptr = reg.get();
+        internal_::error_wrapper(::epoll_ctl, ec, epoll_handle, EPOLL_CTL_ADD, handle, &ev);
+        if (ec) return;
+
+        registrations.emplace(handle, std::move(reg));
+    }
+
+    void reactor::modify_impl(internal_::socket::native_handle_t handle, unsigned events,
+                              std::error_code& ec) noexcept {
+        auto it = registrations.find(handle);
+        if (it == registrations.end()) {
+            ec = std::error_code(ENOENT, error::system_category());
+            return;
+        }
+
+        epoll_event ev{};
+        ev.events = to_epoll_events(events);
+        ev.data.ptr = it->second.get();
+        internal_::error_wrapper(::epoll_ctl, ec, epoll_handle, EPOLL_CTL_MOD, handle, &ev);
+    }
+
+    void reactor::remove_impl(internal_::socket::native_handle_t handle) noexcept {
+        auto it = registrations.find(handle);
+        if (it == registrations.end()) return;
+
+        epoll_event ev{}; // Required by kernels before 2.6.9.
+        ::epoll_ctl(epoll_handle, EPOLL_CTL_DEL, handle, &ev);
+
+        it->second->handle = internal_::socket::not_initialized;
+        removed.push_back(std::move(it->second));
+        registrations.erase(it);
+    }
+
+    size_t reactor::size() const noexcept {
+        return registrations.size();
+    }
+
+    size_t reactor::run_once(std::chrono::milliseconds timeout, std::error_code& ec) noexcept {
+        std::array<epoll_event, 256> events;
+
+        int count = internal_::error_wrapper(::epoll_wait, ec, epoll_handle, events.data(), int(events.size()),
+                                             int(timeout.count()));
+        if (ec) return 0;
+
+        size_t dispatched = 0;
+        for (int i = 0; i < count; ++i) {
+            auto* reg = static_cast<registration*>(events[size_t(i)].data.ptr);
+            if (reg == nullptr) {
+                uint64_t counter;
+                [[maybe_unused]] ssize_t res = ::read(wakeup_handle, &counter, sizeof(counter));
+                continue;
+            }
+
+            // Removed by one of previous handlers.
+            if (reg->handle == internal_::socket::not_initialized) continue;
+
+            reg->handler(from_epoll_events(events[size_t(i)].events));
+            ++dispatched;
+        }
+        removed.clear();
+        return dispatched;
+    }
+
+    void reactor::run(std::error_code& ec) noexcept {
+        while (!stopped) {
+            run_once(std::chrono::milliseconds(-1), ec);
+            if (ec) break;
+        }
+        // Reset on return, not on entry, so stop() called before run() is
+        // not lost.
+        stopped = false;
+    }
+
+    void reactor::stop() noexcept {
+        stopped = true;
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t res = ::write(wakeup_handle, &one, sizeof(one));
+    }
+
+#ifdef __cpp_exceptions
+    reactor::reactor() {
+        std::error_code ec;
+        init(ec);
+        if (ec) throw std::system_error(ec);
+    }
+
+    size_t reactor::run_once(std::chrono::milliseconds timeout) {
+        std::error_code ec;
+        size_t res = run_once(timeout, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    void reactor::run() {
+        std::error_code ec;
+        run(ec);
+        if (ec) throw std::system_error(ec);
+    }
+#endif // ifdef __cpp_exceptions
+} // namespace libwire
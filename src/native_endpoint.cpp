@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/native_endpoint.hpp"
+#include <cstddef>
+#include <cstring>
+#include "libwire/internal/endianess.hpp"
+#include "libwire/internal/system_utils.hpp"
+
+namespace libwire {
+    static_assert(sizeof(sockaddr_in) <= native_endpoint::capacity && sizeof(sockaddr_in6) <= native_endpoint::capacity,
+                  "native_endpoint::capacity is too small for this platform");
+
+    native_endpoint::native_endpoint(const endpoint& ep) noexcept {
+        if (ep.addr.version == ip::v4) {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = internal_::host_to_network(ep.port);
+            std::memcpy(&address.sin_addr, ep.addr.parts.data(), sizeof(address.sin_addr));
+            std::memcpy(storage, &address, sizeof(address));
+            length = sizeof(address);
+        } else if (ep.addr.version == ip::v6) {
+            sockaddr_in6 address{};
+            address.sin6_family = AF_INET6;
+            address.sin6_port = internal_::host_to_network(ep.port);
+            std::memcpy(&address.sin6_addr, ep.addr.parts.data(), sizeof(address.sin6_addr));
+            std::memcpy(storage, &address, sizeof(address));
+            length = sizeof(address);
+        }
+    }
+
+    endpoint native_endpoint::to_endpoint() const noexcept {
+        switch (version()) {
+        case ip::v4: {
+            sockaddr_in address;
+            std::memcpy(&address, storage, sizeof(address));
+            return {memory_view(&address.sin_addr, sizeof(address.sin_addr)),
+                    internal_::network_to_host(address.sin_port)};
+        }
+        case ip::v6: {
+            sockaddr_in6 address;
+            std::memcpy(&address, storage, sizeof(address));
+            return {memory_view(&address.sin6_addr, sizeof(address.sin6_addr)),
+                    internal_::network_to_host(address.sin6_port)};
+        }
+        default:
+            return endpoint::invalid;
+        }
+    }
+
+    ip native_endpoint::version() const noexcept {
+        if (length == 0) return ip(0);
+
+        decltype(sockaddr::sa_family) family;
+        std::memcpy(&family, storage + offsetof(sockaddr, sa_family), sizeof(family));
+        if (family == AF_INET) return ip::v4;
+        if (family == AF_INET6) return ip::v6;
+        return ip(0);
+    }
+
+    bool native_endpoint::is_invalid() const noexcept {
+        return version() == ip(0);
+    }
+
+    bool native_endpoint::operator==(const native_endpoint& rhs) const noexcept {
+        ip ip_version = version();
+        if (ip_version != rhs.version()) return false;
+
+        // Don't compare whole structure: it has padding (sin_zero)
+        // and fields (like sin6_flowinfo) set by kernel.
+        switch (ip_version) {
+        case ip::v4: {
+            sockaddr_in lhs_address, rhs_address;
+            std::memcpy(&lhs_address, storage, sizeof(lhs_address));
+            std::memcpy(&rhs_address, rhs.storage, sizeof(rhs_address));
+            return lhs_address.sin_port == rhs_address.sin_port
+                   && std::memcmp(&lhs_address.sin_addr, &rhs_address.sin_addr, sizeof(lhs_address.sin_addr)) == 0;
+        }
+        case ip::v6: {
+            sockaddr_in6 lhs_address, rhs_address;
+            std::memcpy(&lhs_address, storage, sizeof(lhs_address));
+            std::memcpy(&rhs_address, rhs.storage, sizeof(rhs_address));
+            return lhs_address.sin6_port == rhs_address.sin6_port
+                   && lhs_address.sin6_scope_id == rhs_address.sin6_scope_id
+                   && std::memcmp(&lhs_address.sin6_addr, &rhs_address.sin6_addr, sizeof(lhs_address.sin6_addr)) == 0;
+        }
+        default:
+            return true; // Both invalid.
+        }
+    }
+
+    bool native_endpoint::operator!=(const native_endpoint& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+} // namespace libwire
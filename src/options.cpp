@@ -32,7 +32,7 @@
 #endif
 
 namespace libwire {
-    bool non_blocking_t::get_impl(internal_::socket& sock) noexcept {
+    bool non_blocking_t::get_impl(const internal_::socket& sock) noexcept {
 #if defined(LIBWIRE_POSIX)
         int flags = fcntl(sock.native_handle(), F_GETFL, 0);
         return (flags & O_NONBLOCK) == O_NONBLOCK;
@@ -51,7 +51,7 @@ namespace libwire {
 #if defined(LIBWIRE_WINDOWS)
         unsigned long mode = enable;
         ioctlsocket(sock.native_handle(), FIONBIO, &mode);
-        sock.state.user_non_blocking = true;
 #endif
+        sock.state.user_non_blocking = enable;
     }
 } // namespace libwire
@@ -30,6 +30,10 @@ std::error_code libwire::internal_::last_system_error(int status) noexcept {
     return ec;
 }
 
+std::error_code libwire::internal_::invalid_argument_error() noexcept {
+    return std::error_code(EINVAL, libwire::error::system_category());
+}
+
 const char* libwire::internal_::system_errors::name() const noexcept {
     return "system";
 }
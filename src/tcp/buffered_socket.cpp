@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/tcp/buffered_socket.hpp"
+
+namespace libwire::tcp {
+    template std::vector<uint8_t>& buffered_socket::read(size_t, std::vector<uint8_t>&, std::error_code&);
+    template std::string& buffered_socket::read(size_t, std::string&, std::error_code&);
+
+    template std::vector<uint8_t> buffered_socket::read(size_t, std::error_code&);
+    template std::string buffered_socket::read(size_t, std::error_code&);
+
+    template std::vector<uint8_t>& buffered_socket::read_exactly(size_t, std::vector<uint8_t>&, std::error_code&);
+    template std::string& buffered_socket::read_exactly(size_t, std::string&, std::error_code&);
+
+    template std::vector<uint8_t> buffered_socket::read_exactly(size_t, std::error_code&);
+    template std::string buffered_socket::read_exactly(size_t, std::error_code&);
+
+    template std::vector<uint8_t> buffered_socket::read_until(uint8_t, std::error_code&, size_t);
+    template std::string buffered_socket::read_until(uint8_t, std::error_code&, size_t);
+
+    template std::vector<uint8_t>& buffered_socket::read_until(uint8_t, std::vector<uint8_t>&, std::error_code&,
+                                                               size_t);
+    template std::string& buffered_socket::read_until(uint8_t, std::string&, std::error_code&, size_t);
+
+    template size_t buffered_socket::write(const std::vector<uint8_t>&, std::error_code&);
+    template size_t buffered_socket::write(const std::string&, std::error_code&);
+
+    buffered_socket::buffered_socket(socket&& sock, size_t buffer_size)
+        : sock(std::move(sock)), buffer(buffer_size) {
+    }
+
+    socket& buffered_socket::next_layer() noexcept {
+        return sock;
+    }
+
+    const socket& buffered_socket::next_layer() const noexcept {
+        return sock;
+    }
+
+    size_t buffered_socket::buffered() const noexcept {
+        return end - begin;
+    }
+
+    void buffered_socket::connect(endpoint target, std::error_code& ec) noexcept {
+        begin = end = 0;
+        sock.connect(target, ec);
+    }
+
+    void buffered_socket::close() noexcept {
+        begin = end = 0;
+        sock.close();
+    }
+
+    size_t buffered_socket::fill(std::error_code& ec) noexcept {
+        if (buffer.empty()) buffer.resize(default_buffer_size);
+
+        begin = end = 0;
+        size_t received = sock.impl.read(buffer.data(), buffer.size(), ec);
+        sock.open = (ec != error::generic::disconnected);
+        end = received;
+        return received;
+    }
+
+    size_t buffered_socket::read_some(void* output, size_t length_bytes, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        if (length_bytes == 0) return 0;
+
+        if (begin == end) {
+            if (length_bytes >= buffer.size()) {
+                // Nothing to gain from copying through buffer.
+                size_t received = sock.impl.read(output, length_bytes, ec);
+                sock.open = (ec != error::generic::disconnected);
+                return received;
+            }
+            fill(ec);
+            if (ec) return 0;
+        }
+
+        size_t to_copy = std::min(length_bytes, end - begin);
+        std::memcpy(output, buffer.data() + begin, to_copy);
+        begin += to_copy;
+        return to_copy;
+    }
+
+#ifdef __cpp_exceptions
+    void buffered_socket::connect(endpoint target) {
+        std::error_code ec;
+        connect(target, ec);
+        if (ec) throw std::system_error(ec);
+    }
+
+    template std::vector<uint8_t>& buffered_socket::read(size_t, std::vector<uint8_t>&);
+    template std::string& buffered_socket::read(size_t, std::string&);
+
+    template std::vector<uint8_t> buffered_socket::read(size_t);
+    template std::string buffered_socket::read(size_t);
+
+    template std::vector<uint8_t>& buffered_socket::read_exactly(size_t, std::vector<uint8_t>&);
+    template std::string& buffered_socket::read_exactly(size_t, std::string&);
+
+    template std::vector<uint8_t> buffered_socket::read_exactly(size_t);
+    template std::string buffered_socket::read_exactly(size_t);
+
+    template std::vector<uint8_t>& buffered_socket::read_until(uint8_t, std::vector<uint8_t>&, size_t);
+    template std::string& buffered_socket::read_until(uint8_t, std::string&, size_t);
+
+    template std::vector<uint8_t> buffered_socket::read_until(uint8_t, size_t);
+    template std::string buffered_socket::read_until(uint8_t, size_t);
+
+    template size_t buffered_socket::write(const std::vector<uint8_t>&);
+    template size_t buffered_socket::write(const std::string&);
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::tcp
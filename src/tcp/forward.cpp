@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/tcp/forward.hpp"
+#include <algorithm>
+#include <climits>
+#include "libwire/error.hpp"
+#include "libwire/internal/system_utils.hpp"
+
+#if defined(LIBWIRE_LINUX)
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <signal.h>
+#    include <pthread.h>
+#endif
+
+namespace libwire::tcp {
+    forward_buffer::forward_buffer(size_t capacity) noexcept : capacity(capacity) {
+    }
+
+    forward_buffer::forward_buffer(forward_buffer&& o) noexcept : capacity(o.capacity) {
+        *this = std::move(o);
+    }
+
+    forward_buffer& forward_buffer::operator=(forward_buffer&& o) noexcept {
+        std::swap(capacity, o.capacity);
+        std::swap(pending, o.pending);
+#if defined(LIBWIRE_LINUX)
+        std::swap(pipe_read, o.pipe_read);
+        std::swap(pipe_write, o.pipe_write);
+#else
+        std::swap(data, o.data);
+        std::swap(first, o.first);
+#endif
+        return *this;
+    }
+
+    forward_buffer::~forward_buffer() {
+#if defined(LIBWIRE_LINUX)
+        if (pipe_read != -1) close(pipe_read);
+        if (pipe_write != -1) close(pipe_write);
+#endif
+    }
+
+    size_t forward_buffer::size() const noexcept {
+        return pending;
+    }
+
+    bool forward_buffer::empty() const noexcept {
+        return pending == 0;
+    }
+
+    forward_result forward(socket& from, socket& to, forward_buffer& buffer, std::error_code& ec,
+                           uint64_t max_bytes) noexcept {
+        ec = std::error_code();
+        forward_result result;
+        socket* failed = &from;
+
+#if defined(LIBWIRE_LINUX)
+        if (buffer.pipe_read == -1) {
+            int fds[2];
+            if (internal_::error_wrapper(::pipe2, ec, fds, O_CLOEXEC) < 0) return result;
+            buffer.pipe_read = fds[0];
+            buffer.pipe_write = fds[1];
+
+            // Larger pipe means less system calls per byte, but default
+            // one is still usable if we are not allowed to grow it.
+            int size = fcntl(buffer.pipe_write, F_SETPIPE_SZ, int(std::min(buffer.capacity, size_t(INT_MAX))));
+            if (size < 0) size = fcntl(buffer.pipe_write, F_GETPIPE_SZ);
+            buffer.capacity = size_t(size);
+        }
+
+        // splice() has no MSG_NOSIGNAL equivalent, so SIGPIPE is blocked
+        // while we work and discarded if it's raised by us.
+        sigset_t sigpipe, old_mask;
+        sigemptyset(&sigpipe);
+        sigaddset(&sigpipe, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+
+        // Pipe is never waited on: data is put into it only when it's empty
+        // and taken only as much as there is, so blocking behavior is
+        // defined only by sockets.
+        const unsigned flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+        while (result.bytes < max_bytes) {
+            if (buffer.pending == 0) {
+                failed = &from;
+                size_t length = size_t(std::min(uint64_t(buffer.capacity), max_bytes - result.bytes));
+                ssize_t received = internal_::error_wrapper(::splice, ec, from.impl.handle, nullptr,
+                                                            buffer.pipe_write, nullptr, length, flags);
+                if (ec) break;
+                if (received == 0) {
+                    to.shutdown(false, true);
+                    result.half_closed = true;
+                    break;
+                }
+                buffer.pending = size_t(received);
+            }
+
+            failed = &to;
+            size_t length = size_t(std::min(uint64_t(buffer.pending), max_bytes - result.bytes));
+            ssize_t sent =
+                internal_::error_wrapper(::splice, ec, buffer.pipe_read, nullptr, to.impl.handle, nullptr, length, flags);
+            if (ec) break;
+            buffer.pending -= size_t(sent);
+            result.bytes += uint64_t(sent);
+        }
+
+        if (ec == error::broken_pipe && sigismember(&old_mask, SIGPIPE) == 0) {
+            timespec no_wait{};
+            sigtimedwait(&sigpipe, nullptr, &no_wait);
+        }
+        pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+#else
+        if (buffer.data.empty()) buffer.data.resize(buffer.capacity);
+
+        while (result.bytes < max_bytes) {
+            if (buffer.pending == 0) {
+                failed = &from;
+                size_t length = size_t(std::min(uint64_t(buffer.data.size()), max_bytes - result.bytes));
+                buffer.first = 0;
+                buffer.pending = from.impl.read(buffer.data.data(), length, ec);
+                if (ec == error::end_of_file) {
+                    ec = std::error_code();
+                    to.shutdown(false, true);
+                    result.half_closed = true;
+                    break;
+                }
+                if (ec) break;
+            }
+
+            failed = &to;
+            size_t length = size_t(std::min(uint64_t(buffer.pending), max_bytes - result.bytes));
+            size_t sent = to.impl.write(buffer.data.data() + buffer.first, length, ec);
+            if (ec) break;
+            buffer.first += sent;
+            buffer.pending -= sent;
+            result.bytes += sent;
+        }
+#endif
+
+        if (ec == error::generic::disconnected) failed->open = false;
+        return result;
+    }
+
+#ifdef __cpp_exceptions
+    forward_result forward(socket& from, socket& to, forward_buffer& buffer, uint64_t max_bytes) {
+        std::error_code ec;
+        forward_result res = forward(from, to, buffer, ec, max_bytes);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::tcp
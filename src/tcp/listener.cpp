@@ -24,15 +24,57 @@
 
 namespace libwire::tcp {
     void listener::listen(endpoint target, std::error_code& ec, unsigned max_backlog) noexcept {
-        implementation = internal_::socket(target.addr.version, transport::tcp, ec);
+        impl = internal_::socket(target.addr.version, transport::tcp, ec, internal_::socket::close_on_exec);
         if (ec) return;
-        implementation.bind(target, ec);
+        if (reuse_port_enabled) {
+            impl.reuse_port(true, ec);
+            if (ec) return;
+        }
+        impl.bind(target, ec);
         if (ec) return;
-        implementation.listen(int(max_backlog), ec);
+        impl.listen(int(max_backlog), ec);
     }
 
     socket listener::accept(std::error_code& ec) noexcept {
-        return {implementation.accept(ec)};
+        endpoint peer = endpoint::invalid;
+        internal_::socket accepted = impl.accept(ec, &peer, accept_flags);
+        return {std::move(accepted), peer};
+    }
+
+    void listener::set_accept_non_blocking(bool enable) noexcept {
+        if (enable) {
+            accept_flags |= internal_::socket::non_blocking;
+        } else {
+            accept_flags &= ~unsigned(internal_::socket::non_blocking);
+        }
+    }
+
+    bool listener::accept_non_blocking() const noexcept {
+        return (accept_flags & internal_::socket::non_blocking) != 0;
+    }
+
+    void listener::set_reuse_port(bool enable) noexcept {
+        reuse_port_enabled = enable;
+    }
+
+    bool listener::reuse_port() const noexcept {
+        return reuse_port_enabled;
+    }
+
+    endpoint listener::local_endpoint() const noexcept {
+        return impl.local_endpoint();
+    }
+
+    internal_::socket::native_handle_t listener::native_handle() const noexcept {
+        return impl.native_handle();
+    }
+
+    internal_::socket& listener::implementation() noexcept {
+        return impl;
+    }
+
+    const internal_::socket& listener::implementation() const noexcept {
+        return impl;
     }
 
     void listener::listen(endpoint target, unsigned max_backlog) {
@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/tcp/listener_group.hpp"
+
+namespace libwire::tcp {
+    void listener_group::listen(endpoint target, size_t count, std::error_code& ec, unsigned max_backlog) noexcept {
+        ec = std::error_code();
+        listeners.clear();
+        listeners.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            listener& l = listeners.emplace_back();
+            l.set_reuse_port(true);
+            l.listen(target, ec, max_backlog);
+            if (ec) {
+                listeners.clear();
+                return;
+            }
+
+            // Bind remaining listeners to port picked by first one.
+            if (target.port == 0) target = l.local_endpoint();
+        }
+    }
+
+    void listener_group::close() noexcept {
+        listeners.clear();
+    }
+
+    void listener_group::set_accept_non_blocking(bool enable) noexcept {
+        for (listener& l : listeners) {
+            l.set_accept_non_blocking(enable);
+        }
+    }
+
+    endpoint listener_group::local_endpoint() const noexcept {
+        if (listeners.empty()) return endpoint::invalid;
+        return listeners.front().local_endpoint();
+    }
+
+    size_t listener_group::size() const noexcept {
+        return listeners.size();
+    }
+
+    listener& listener_group::operator[](size_t index) noexcept {
+        return listeners[index];
+    }
+
+    const listener& listener_group::operator[](size_t index) const noexcept {
+        return listeners[index];
+    }
+
+    listener_group::iterator listener_group::begin() noexcept {
+        return listeners.begin();
+    }
+
+    listener_group::iterator listener_group::end() noexcept {
+        return listeners.end();
+    }
+
+    listener_group::const_iterator listener_group::begin() const noexcept {
+        return listeners.begin();
+    }
+
+    listener_group::const_iterator listener_group::end() const noexcept {
+        return listeners.end();
+    }
+
+#ifdef __cpp_exceptions
+    void listener_group::listen(endpoint target, size_t count, unsigned max_backlog) {
+        std::error_code ec;
+        listen(target, count, ec, max_backlog);
+        if (ec) throw std::system_error(ec);
+    }
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::tcp
@@ -21,6 +21,7 @@
  */
 
 #include "libwire/tcp/socket.hpp"
+#include <algorithm>
 
 namespace libwire::tcp {
     template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&);
@@ -32,14 +33,24 @@ namespace libwire::tcp {
     template size_t socket::write(const std::vector<uint8_t>&, std::error_code&);
     template size_t socket::write(const std::string&, std::error_code&);
 
+    template size_t socket::read_some(std::vector<uint8_t>&, std::error_code&);
+    template size_t socket::read_some(std::string&, std::error_code&);
+    template size_t socket::read_some(memory_view&, std::error_code&);
+
+    template size_t socket::write_some(const std::vector<uint8_t>&, std::error_code&);
+    template size_t socket::write_some(const std::string&, std::error_code&);
+
+    template size_t socket::write_all(const std::vector<uint8_t>&, std::error_code&, size_t);
+    template size_t socket::write_all(const std::string&, std::error_code&, size_t);
+
     template std::vector<uint8_t> socket::read_until(uint8_t, std::error_code&, size_t);
     template std::string socket::read_until(uint8_t, std::error_code&, size_t);
 
     template std::vector<uint8_t>& socket::read_until(uint8_t, std::vector<uint8_t>&, std::error_code&, size_t);
     template std::string& socket::read_until(uint8_t, std::string&, std::error_code&, size_t);
 
-    socket::socket(internal_::socket&& i) noexcept : implementation(std::move(i)) {
-        open = (implementation.native_handle() != internal_::socket::not_initialized);
+    socket::socket(internal_::socket&& i, const endpoint& peer) noexcept : impl(std::move(i)), peer(peer) {
+        open = (impl.native_handle() != internal_::socket::not_initialized);
     }
 
     socket::~socket() {
@@ -49,7 +60,15 @@ namespace libwire::tcp {
     }
 
     internal_::socket::native_handle_t socket::native_handle() const noexcept {
-        return implementation.native_handle();
+        return impl.native_handle();
+    }
+
+    internal_::socket& socket::implementation() noexcept {
+        return impl;
+    }
+
+    const internal_::socket& socket::implementation() const noexcept {
+        return impl;
     }
 
     bool socket::is_open() const {
@@ -57,29 +76,109 @@ namespace libwire::tcp {
     }
 
     void socket::connect(endpoint target, std::error_code& ec) noexcept {
-        implementation = internal_::socket(target.addr.version, transport::tcp, ec);
+        impl = internal_::socket(target.addr.version, transport::tcp, ec, internal_::socket::close_on_exec);
         if (ec) return;
-        implementation.connect(target, ec);
+        impl.connect(target, ec);
         open = !ec;
+        peer = open ? target : endpoint::invalid;
     }
 
     void socket::close() noexcept {
         // Reassignment to null socket will call destructor and
         // close destroyed socket.
-        implementation = internal_::socket();
+        impl = internal_::socket();
+        peer = endpoint::invalid;
         open = false;
     }
 
     void socket::shutdown(bool read, bool write) noexcept {
-        implementation.shutdown(read, write);
+        impl.shutdown(read, write);
     }
 
     endpoint socket::local_endpoint() const noexcept {
-        return implementation.local_endpoint();
+        return impl.local_endpoint();
     }
 
     endpoint socket::remote_endpoint() const noexcept {
-        return implementation.remote_endpoint();
+        if (!peer.is_invalid()) return peer;
+        return impl.remote_endpoint();
+    }
+
+    size_t socket::write(std::initializer_list<memory_view> buffers, std::error_code& ec) noexcept {
+        return write_sequence(buffers.begin(), buffers.size(), ec);
+    }
+
+    size_t socket::write(const std::vector<memory_view>& buffers, std::error_code& ec) noexcept {
+        return write_sequence(buffers.data(), buffers.size(), ec);
+    }
+
+    size_t socket::read(std::initializer_list<memory_view> buffers, std::error_code& ec) noexcept {
+        return read_sequence(buffers.begin(), buffers.size(), ec);
+    }
+
+    size_t socket::read(const std::vector<memory_view>& buffers, std::error_code& ec) noexcept {
+        return read_sequence(buffers.data(), buffers.size(), ec);
+    }
+
+    /**
+     * Call transfer (writev or readv) until all buffers are processed
+     * or error occurred.
+     */
+    template<typename Transfer>
+    static size_t transfer_sequence(const memory_view* buffers, size_t count, std::error_code& ec,
+                                    const Transfer& transfer) noexcept {
+        size_t total_size = 0;
+        for (size_t i = 0; i < count; ++i) total_size += buffers[i].size();
+
+        size_t total = transfer(buffers, count);
+        if (ec || total == total_size) return total;
+
+        // Partial transfer, continue with copy of not processed part.
+        std::vector<memory_view> rest(buffers, buffers + count);
+        size_t first = 0, transferred = total;
+        while (true) {
+            while (first < rest.size() && transferred >= rest[first].size()) {
+                transferred -= rest[first].size();
+                ++first;
+            }
+            if (first == rest.size()) break;
+            rest[first].shrink_front(transferred);
+
+            transferred = transfer(rest.data() + first, rest.size() - first);
+            if (ec) break;
+            total += transferred;
+        }
+        return total;
+    }
+
+    size_t socket::write_sequence(const memory_view* buffers, size_t count, std::error_code& ec) noexcept {
+        size_t res = transfer_sequence(buffers, count, ec, [&](const memory_view* first, size_t n) {
+            return impl.writev(first, n, ec);
+        });
+        open = (ec != error::generic::disconnected);
+        return res;
+    }
+
+    size_t socket::read_sequence(const memory_view* buffers, size_t count, std::error_code& ec) noexcept {
+        size_t res = transfer_sequence(buffers, count, ec, [&](const memory_view* first, size_t n) {
+            return impl.readv(first, n, ec);
+        });
+        open = (ec != error::generic::disconnected);
+        return res;
+    }
+
+    uint64_t socket::send_file(internal_::socket::native_file_t file, uint64_t offset, uint64_t length,
+                               std::error_code& ec) noexcept {
+        ec = std::error_code();
+        uint64_t sent = 0;
+        while (sent < length) {
+            size_t chunk = size_t(std::min(length - sent, uint64_t(SIZE_MAX)));
+            sent += impl.sendfile(file, offset + sent, chunk, ec);
+            if (ec) break;
+        }
+        // end_of_file here refers to file, not to connection.
+        open = (ec != error::generic::disconnected || ec == error::end_of_file);
+        return sent;
     }
 
 #ifdef __cpp_exceptions
@@ -89,6 +188,41 @@ namespace libwire::tcp {
         if (ec) throw std::system_error(ec);
     }
 
+    uint64_t socket::send_file(internal_::socket::native_file_t file, uint64_t offset, uint64_t length) {
+        std::error_code ec;
+        uint64_t res = send_file(file, offset, length, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    size_t socket::write(std::initializer_list<memory_view> buffers) {
+        std::error_code ec;
+        size_t res = write(buffers, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    size_t socket::write(const std::vector<memory_view>& buffers) {
+        std::error_code ec;
+        size_t res = write(buffers, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    size_t socket::read(std::initializer_list<memory_view> buffers) {
+        std::error_code ec;
+        size_t res = read(buffers, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    size_t socket::read(const std::vector<memory_view>& buffers) {
+        std::error_code ec;
+        size_t res = read(buffers, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
     template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&);
     template std::string& socket::read(size_t, std::string&);
 
@@ -98,6 +232,16 @@ namespace libwire::tcp {
     template size_t socket::write(const std::vector<uint8_t>&);
     template size_t socket::write(const std::string&);
 
+    template size_t socket::read_some(std::vector<uint8_t>&);
+    template size_t socket::read_some(std::string&);
+    template size_t socket::read_some(memory_view&);
+
+    template size_t socket::write_some(const std::vector<uint8_t>&);
+    template size_t socket::write_some(const std::string&);
+
+    template size_t socket::write_all(const std::vector<uint8_t>&, size_t);
+    template size_t socket::write_all(const std::string&, size_t);
+
     template std::vector<uint8_t>& socket::read_until(uint8_t, std::vector<uint8_t>&, size_t);
     template std::string& socket::read_until(uint8_t, std::string&, size_t);
 
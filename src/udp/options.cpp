@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "libwire/udp/options.hpp"
+#include "libwire/udp/socket.hpp"
+#include "libwire/internal/platform.hpp"
+
+#if defined(LIBWIRE_POSIX)
+#    include <sys/socket.h>
+#    include <netinet/in.h>
+#endif
+#if defined(LIBWIRE_LINUX)
+#    include <netinet/udp.h>
+#endif
+
+namespace libwire::udp {
+    void receive_offload_t::set(socket& sock, bool enabled) noexcept {
+#ifdef UDP_GRO
+        int value = int(enabled);
+        setsockopt(sock.native_handle(), SOL_UDP, UDP_GRO, &value, sizeof(value));
+#else
+        (void)sock;
+        (void)enabled; // Silence "unused parameter" warnings.
+#endif
+    }
+
+    bool receive_offload_t::get(const socket& sock) noexcept {
+#ifdef UDP_GRO
+        int result = 0;
+        socklen_t result_size = sizeof(result);
+        getsockopt(sock.native_handle(), SOL_UDP, UDP_GRO, &result, &result_size);
+        return bool(result);
+#else
+        (void)sock;
+        return false;
+#endif
+    }
+
+    void receive_packet_info_t::set(socket& sock, bool enabled) noexcept {
+#if defined(IP_PKTINFO) && defined(IPV6_RECVPKTINFO)
+        int value = int(enabled);
+        // Only one of them is applicable, depending on socket version.
+        if (setsockopt(sock.native_handle(), IPPROTO_IPV6, IPV6_RECVPKTINFO, &value, sizeof(value)) < 0) {
+            setsockopt(sock.native_handle(), IPPROTO_IP, IP_PKTINFO, &value, sizeof(value));
+        }
+#else
+        (void)sock;
+        (void)enabled; // Silence "unused parameter" warnings.
+#endif
+    }
+
+    bool receive_packet_info_t::get(const socket& sock) noexcept {
+#if defined(IP_PKTINFO) && defined(IPV6_RECVPKTINFO)
+        int result = 0;
+        socklen_t result_size = sizeof(result);
+        if (getsockopt(sock.native_handle(), IPPROTO_IPV6, IPV6_RECVPKTINFO, &result, &result_size) < 0) {
+            result_size = sizeof(result);
+            getsockopt(sock.native_handle(), IPPROTO_IP, IP_PKTINFO, &result, &result_size);
+        }
+        return bool(result);
+#else
+        (void)sock;
+        return false;
+#endif
+    }
+
+    void receive_timestamp_t::set(socket& sock, bool enabled) noexcept {
+#ifdef SO_TIMESTAMPNS
+        int value = int(enabled);
+        setsockopt(sock.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value));
+#else
+        (void)sock;
+        (void)enabled; // Silence "unused parameter" warnings.
+#endif
+    }
+
+    bool receive_timestamp_t::get(const socket& sock) noexcept {
+#ifdef SO_TIMESTAMPNS
+        int result = 0;
+        socklen_t result_size = sizeof(result);
+        getsockopt(sock.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &result, &result_size);
+        return bool(result);
+#else
+        (void)sock;
+        return false;
+#endif
+    }
+
+    void receive_drop_count_t::set(socket& sock, bool enabled) noexcept {
+#ifdef SO_RXQ_OVFL
+        int value = int(enabled);
+        setsockopt(sock.native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &value, sizeof(value));
+#else
+        (void)sock;
+        (void)enabled; // Silence "unused parameter" warnings.
+#endif
+    }
+
+    bool receive_drop_count_t::get(const socket& sock) noexcept {
+#ifdef SO_RXQ_OVFL
+        int result = 0;
+        socklen_t result_size = sizeof(result);
+        getsockopt(sock.native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &result, &result_size);
+        return bool(result);
+#else
+        (void)sock;
+        return false;
+#endif
+    }
+} // namespace libwire::udp
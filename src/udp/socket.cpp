@@ -21,6 +21,7 @@
  */
 
 #include "libwire/udp/socket.hpp"
+#include "libwire/options.hpp"
 
 namespace libwire::udp {
     template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&, endpoint*);
@@ -32,9 +33,46 @@ namespace libwire::udp {
     template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const endpoint&);
     template size_t socket::write(const std::string&, std::error_code&, const endpoint&);
 
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&, native_endpoint&);
+    template std::string& socket::read(size_t, std::string&, std::error_code&, native_endpoint&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const native_endpoint&);
+    template size_t socket::write(const std::string&, std::error_code&, const native_endpoint&);
+
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&, endpoint&,
+                                                packet_info&);
+    template std::string& socket::read(size_t, std::string&, std::error_code&, endpoint&, packet_info&);
+
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, std::error_code&, native_endpoint&,
+                                                packet_info&);
+    template std::string& socket::read(size_t, std::string&, std::error_code&, native_endpoint&, packet_info&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const endpoint&, const packet_info&);
+    template size_t socket::write(const std::string&, std::error_code&, const endpoint&, const packet_info&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, std::error_code&, const native_endpoint&,
+                                  const packet_info&);
+    template size_t socket::write(const std::string&, std::error_code&, const native_endpoint&, const packet_info&);
+
+    template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, std::error_code&, const endpoint&);
+    template size_t socket::write_segmented(const std::string&, size_t, std::error_code&, const endpoint&);
+
+    template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, std::error_code&,
+                                            const native_endpoint&);
+    template size_t socket::write_segmented(const std::string&, size_t, std::error_code&, const native_endpoint&);
+
     socket::socket(ip ipver) noexcept {
         std::error_code ec;
-        impl = internal_::socket(ipver, transport::udp, ec);
+        impl = internal_::socket(ipver, transport::udp, ec, internal_::socket::close_on_exec);
+        if (ec) {
+            impl = internal_::socket();
+        }
+    }
+
+    socket::socket(ip ipver, non_blocking_t) noexcept {
+        std::error_code ec;
+        impl = internal_::socket(ipver, transport::udp, ec,
+                                 internal_::socket::close_on_exec | internal_::socket::non_blocking);
         if (ec) {
             impl = internal_::socket();
         }
@@ -48,6 +86,14 @@ namespace libwire::udp {
         return impl.native_handle();
     }
 
+    internal_::socket& socket::implementation() noexcept {
+        return impl;
+    }
+
+    const internal_::socket& socket::implementation() const noexcept {
+        return impl;
+    }
+
     void socket::associate(endpoint target, std::error_code& ec) noexcept {
         impl.connect(target, ec);
     }
@@ -60,6 +106,41 @@ namespace libwire::udp {
         impl.bind(target, ec);
     }
 
+    size_t socket::read_batch(datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        return impl.recvmmsg(datagrams, count, ec);
+    }
+
+    size_t socket::read_batch(std::vector<datagram>& datagrams, std::error_code& ec) noexcept {
+        return impl.recvmmsg(datagrams.data(), datagrams.size(), ec);
+    }
+
+    size_t socket::write_batch(datagram* datagrams, size_t count, std::error_code& ec) noexcept {
+        return impl.sendmmsg(datagrams, count, ec);
+    }
+
+    size_t socket::write_batch(std::vector<datagram>& datagrams, std::error_code& ec) noexcept {
+        return impl.sendmmsg(datagrams.data(), datagrams.size(), ec);
+    }
+
+    coalesced_datagram socket::read_coalesced(memory_view buffer, std::error_code& ec, endpoint* source) noexcept {
+        if (source == nullptr) {
+            return impl.recv_coalesced(buffer, nullptr, ec);
+        }
+        native_endpoint native_source;
+        coalesced_datagram result = impl.recv_coalesced(buffer, &native_source, ec);
+        if (!ec) *source = native_source.to_endpoint();
+        return result;
+    }
+
+    coalesced_datagram socket::read_coalesced(memory_view buffer, std::error_code& ec,
+                                              native_endpoint& source) noexcept {
+        return impl.recv_coalesced(buffer, &source, ec);
+    }
+
+    datagram_info socket::read(memory_view buffer, std::error_code& ec) noexcept {
+        return impl.recv_info(buffer, ec);
+    }
+
     void socket::close() noexcept {
         // Reassignment to null socket will call destructor and
         // close destroyed socket.
@@ -79,12 +160,47 @@ namespace libwire::udp {
         if (ec) throw std::system_error(ec);
     }
 
-    internal_::socket& socket::implementation() noexcept {
-        return impl;
+    size_t socket::read_batch(datagram* datagrams, size_t count) {
+        std::error_code ec;
+        size_t res = read_batch(datagrams, count, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
     }
 
-    const internal_::socket& socket::implementation() const noexcept {
-        return impl;
+    size_t socket::read_batch(std::vector<datagram>& datagrams) {
+        return read_batch(datagrams.data(), datagrams.size());
+    }
+
+    size_t socket::write_batch(datagram* datagrams, size_t count) {
+        std::error_code ec;
+        size_t res = write_batch(datagrams, count, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    size_t socket::write_batch(std::vector<datagram>& datagrams) {
+        return write_batch(datagrams.data(), datagrams.size());
+    }
+
+    coalesced_datagram socket::read_coalesced(memory_view buffer, endpoint* source) {
+        std::error_code ec;
+        coalesced_datagram res = read_coalesced(buffer, ec, source);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    coalesced_datagram socket::read_coalesced(memory_view buffer, native_endpoint& source) {
+        std::error_code ec;
+        coalesced_datagram res = read_coalesced(buffer, ec, source);
+        if (ec) throw std::system_error(ec);
+        return res;
+    }
+
+    datagram_info socket::read(memory_view buffer) {
+        std::error_code ec;
+        datagram_info res = read(buffer, ec);
+        if (ec) throw std::system_error(ec);
+        return res;
     }
 
     template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, endpoint*);
@@ -95,6 +211,30 @@ namespace libwire::udp {
 
     template size_t socket::write(const std::vector<uint8_t>&, const endpoint&);
     template size_t socket::write(const std::string&, const endpoint&);
+
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, native_endpoint&);
+    template std::string& socket::read(size_t, std::string&, native_endpoint&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, const native_endpoint&);
+    template size_t socket::write(const std::string&, const native_endpoint&);
+
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, endpoint&, packet_info&);
+    template std::string& socket::read(size_t, std::string&, endpoint&, packet_info&);
+
+    template std::vector<uint8_t>& socket::read(size_t, std::vector<uint8_t>&, native_endpoint&, packet_info&);
+    template std::string& socket::read(size_t, std::string&, native_endpoint&, packet_info&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, const endpoint&, const packet_info&);
+    template size_t socket::write(const std::string&, const endpoint&, const packet_info&);
+
+    template size_t socket::write(const std::vector<uint8_t>&, const native_endpoint&, const packet_info&);
+    template size_t socket::write(const std::string&, const native_endpoint&, const packet_info&);
+
+    template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, const endpoint&);
+    template size_t socket::write_segmented(const std::string&, size_t, const endpoint&);
+
+    template size_t socket::write_segmented(const std::vector<uint8_t>&, size_t, const native_endpoint&);
+    template size_t socket::write_segmented(const std::string&, size_t, const native_endpoint&);
 #endif // ifdef __cpp_exceptions
 
 } // namespace libwire::udp
@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "libwire/udp/socket_group.hpp"
+#include "libwire/internal/platform.hpp"
+#include "libwire/internal/system_errors.hpp"
+
+#if defined(LIBWIRE_LINUX)
+#    include <sys/socket.h>
+#    include <linux/filter.h>
+#endif
+
+namespace libwire::udp {
+    void socket_group::listen(endpoint target, size_t count, std::error_code& ec) noexcept {
+        ec = std::error_code();
+        sockets.clear();
+        sockets.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            socket& s = sockets.emplace_back(target.addr.version);
+            if (!s.implementation()) {
+                // Constructor reports allocation failure only by closed state.
+                ec = internal_::last_system_error();
+                sockets.clear();
+                return;
+            }
+            s.implementation().reuse_port(true, ec);
+            if (!ec) s.listen(target, ec);
+            if (ec) {
+                sockets.clear();
+                return;
+            }
+
+            // Bind remaining sockets to port picked by first one.
+            if (target.port == 0) target = s.implementation().local_endpoint();
+        }
+    }
+
+    void socket_group::steer_by_cpu(std::error_code& ec) noexcept {
+        ec = std::error_code();
+#if defined(LIBWIRE_LINUX) && defined(SO_ATTACH_REUSEPORT_CBPF)
+        if (sockets.empty()) {
+            ec = internal_::invalid_argument_error();
+            return;
+        }
+
+        // return cpu % size;
+        sock_filter code[] = {
+            {BPF_LD | BPF_W | BPF_ABS, 0, 0, uint32_t(SKF_AD_OFF + SKF_AD_CPU)},
+            {BPF_ALU | BPF_MOD | BPF_K, 0, 0, uint32_t(sockets.size())},
+            {BPF_RET | BPF_A, 0, 0, 0},
+        };
+        sock_fprog program{sizeof(code) / sizeof(code[0]), code};
+        // Program is shared by whole group, attaching to any socket is enough.
+        if (setsockopt(sockets.front().native_handle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                       sizeof(program))
+            < 0) {
+            ec = internal_::last_system_error();
+        }
+#else
+        ec = std::make_error_code(std::errc::not_supported);
+#endif
+    }
+
+    void socket_group::close() noexcept {
+        sockets.clear();
+    }
+
+    endpoint socket_group::local_endpoint() const noexcept {
+        if (sockets.empty()) return endpoint::invalid;
+        return sockets.front().implementation().local_endpoint();
+    }
+
+    size_t socket_group::size() const noexcept {
+        return sockets.size();
+    }
+
+    socket& socket_group::operator[](size_t index) noexcept {
+        return sockets[index];
+    }
+
+    const socket& socket_group::operator[](size_t index) const noexcept {
+        return sockets[index];
+    }
+
+    socket_group::iterator socket_group::begin() noexcept {
+        return sockets.begin();
+    }
+
+    socket_group::iterator socket_group::end() noexcept {
+        return sockets.end();
+    }
+
+    socket_group::const_iterator socket_group::begin() const noexcept {
+        return sockets.begin();
+    }
+
+    socket_group::const_iterator socket_group::end() const noexcept {
+        return sockets.end();
+    }
+
+#ifdef __cpp_exceptions
+    void socket_group::listen(endpoint target, size_t count) {
+        std::error_code ec;
+        listen(target, count, ec);
+        if (ec) throw std::system_error(ec);
+    }
+
+    void socket_group::steer_by_cpu() {
+        std::error_code ec;
+        steer_by_cpu(ec);
+        if (ec) throw std::system_error(ec);
+    }
+#endif // ifdef __cpp_exceptions
+} // namespace libwire::udp
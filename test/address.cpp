@@ -21,7 +21,17 @@
  */
 
 #include "gtest.hpp"
+#include <array>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
 #include <libwire/address.hpp>
+#include <libwire/error.hpp>
+#include <libwire/internal/platform.hpp>
+#ifdef LIBWIRE_POSIX
+#    include <arpa/inet.h>
+#endif
 
 TEST(Ipv4Address, VersionInitialization) {
     using namespace libwire;
@@ -75,3 +85,135 @@ TEST(Ipv6Address, FromString) {
     // Incorrectly folded, we reject it for security reasons.
     ASSERT_THROW(address(":00::000:1"), std::invalid_argument);
 }
+
+TEST(Ipv4Address, Parse) {
+    using namespace libwire;
+
+    std::error_code ec;
+    ASSERT_EQ(address::parse("192.168.1.254", ec), address(192, 168, 1, 254));
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(address::parse("0.0.0.0", ec), ipv4::any);
+    ASSERT_EQ(address::parse("255.255.255.255", ec), ipv4::broadcast);
+    ASSERT_FALSE(ec);
+
+    for (const char* text : {"", "1.2.3", "1.2.3.4.", "1.2.3.4.5", "01.2.3.4", "1.2.3.256", "1..2.3", "a.b.c.d",
+                             "1.2.3.4 ", " 1.2.3.4", "1.2.3.-4", "1.2.3.4:80"}) {
+        ASSERT_TRUE(address::parse(text, ec).is_invalid()) << text;
+        ASSERT_EQ(ec, error::invalid_argument) << text;
+    }
+
+    // Only IPv6 is accepted.
+    ASSERT_TRUE(address::parse("127.0.0.1", ec, ip::v6).is_invalid());
+    ASSERT_EQ(ec, error::invalid_argument);
+    ASSERT_THROW(address::parse("1.2.3"), std::system_error);
+
+    // Error left from previous call is cleared.
+    ec = std::make_error_code(std::errc::timed_out);
+    ASSERT_EQ(address::parse("1.2.3.4", ec), address(1, 2, 3, 4));
+    ASSERT_FALSE(ec);
+}
+
+TEST(Ipv6Address, Parse) {
+    using namespace libwire;
+
+    std::error_code ec;
+    ASSERT_EQ(address::parse("::", ec), ipv6::any);
+    ASSERT_EQ(address::parse("::1", ec), ipv6::loopback);
+    ASSERT_EQ(address::parse("2001:DB8::FF00:42:8329", ec),
+              address(0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff, 0x00, 0x00, 0x42, 0x83, 0x29));
+    ASSERT_EQ(address::parse("2001:0db8:0000:0000:0000:ff00:0042:8329", ec),
+              address(0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff, 0x00, 0x00, 0x42, 0x83, 0x29));
+    ASSERT_EQ(address::parse("fe80::", ec), address(0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+    ASSERT_EQ(address::parse("1:2:3:4:5:6:7::", ec), address(0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0, 7, 0, 0));
+    ASSERT_EQ(address::parse("::ffff:192.0.2.128", ec),
+              address(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 192, 0, 2, 128));
+    ASSERT_EQ(address::parse("1:2:3:4:5:6:1.2.3.4", ec), address(0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 1, 2, 3, 4));
+    ASSERT_FALSE(ec);
+
+    for (const char* text : {":", ":::", "1:::2", "1::2::3", "12345::", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7",
+                             "1:2:3:4:5:6:7:8::", "::1:", ":1::", "g::", "::1.2.3", "1:2:3:4:5:6:7:1.2.3.4",
+                             "::1.2.3.4:5", "fe80::1%eth0", "[::1]"}) {
+        ASSERT_TRUE(address::parse(text, ec).is_invalid()) << text;
+        ASSERT_EQ(ec, error::invalid_argument) << text;
+    }
+}
+
+#ifdef LIBWIRE_POSIX
+TEST(Address, ParseMatchesInetPton) {
+    using namespace libwire;
+
+    // Random mutations of valid addresses, mostly near-valid strings.
+    const std::string alphabet = "0123456789abcdefABCDEFg:.%";
+    const std::vector<std::string> seeds = {"0.0.0.0", "192.168.1.254", "255.255.255.255", "::", "::1",
+                                            "2001:db8::ff00:42:8329", "1:2:3:4:5:6:7:8", "::ffff:192.0.2.128",
+                                            "fe80::1:2", "1:2:3:4:5:6:1.2.3.4"};
+    std::mt19937 random(42);
+    for (size_t i = 0; i < 200000; ++i) {
+        std::string text = seeds[random() % seeds.size()];
+        for (size_t mutations = 1 + random() % 3; mutations != 0; --mutations) {
+            size_t pos = random() % (text.size() + 1);
+            switch (random() % 3) {
+            case 0: text.insert(pos, 1, alphabet[random() % alphabet.size()]); break;
+            case 1:
+                if (pos < text.size()) text.erase(pos, 1);
+                break;
+            case 2:
+                if (pos < text.size()) text[pos] = alphabet[random() % alphabet.size()];
+                break;
+            }
+        }
+
+        for (auto [version, family] : {std::pair{ip::v4, AF_INET}, std::pair{ip::v6, AF_INET6}}) {
+            std::array<uint8_t, 16> expected{};
+            bool valid = inet_pton(family, text.c_str(), expected.data()) == 1;
+
+            std::error_code ec;
+            address parsed = address::parse(text, ec, version);
+            ASSERT_EQ(!ec, valid) << text;
+            if (valid) {
+                ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + (version == ip::v4 ? 4 : 16),
+                                       parsed.parts.begin()))
+                    << text;
+            }
+        }
+    }
+}
+#endif
+
+TEST(Ipv6Address, ToString) {
+    using namespace libwire;
+
+    ASSERT_EQ(ipv6::any.to_string(), "::");
+    ASSERT_EQ(ipv6::loopback.to_string(), "::1");
+    ASSERT_EQ(address("2001:0DB8:0000:0000:0000:FF00:0042:8329").to_string(), "2001:db8::ff00:42:8329");
+    ASSERT_EQ(address("fe80::").to_string(), "fe80::");
+    // Single zero group is not compressed, first of two equal runs is.
+    ASSERT_EQ(address("1:0:2:3:4:5:6:7").to_string(), "1:0:2:3:4:5:6:7");
+    ASSERT_EQ(address("1:0:0:2:3:0:0:4").to_string(), "1::2:3:0:0:4");
+    ASSERT_EQ(address("1:0:0:2:0:0:0:3").to_string(), "1:0:0:2::3");
+    ASSERT_EQ(address("::ffff:192.0.2.128").to_string(), "::ffff:192.0.2.128");
+}
+
+TEST(Address, ToChars) {
+    using namespace libwire;
+
+    std::array<char, address::max_text_length> buffer;
+    address longest("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255");
+    auto result = longest.to_chars(buffer.data(), buffer.data() + buffer.size());
+    ASSERT_EQ(result.ec, std::errc());
+    ASSERT_EQ(std::string(buffer.data(), result.ptr), longest.to_string());
+
+    address addr(192, 168, 1, 254);
+    result = addr.to_chars(buffer.data(), buffer.data() + 13);
+    ASSERT_EQ(result.ec, std::errc());
+    ASSERT_EQ(std::string(buffer.data(), result.ptr), "192.168.1.254");
+
+    char* last = buffer.data() + 12;
+    result = addr.to_chars(buffer.data(), last);
+    ASSERT_EQ(result.ec, std::errc::value_too_large);
+    ASSERT_EQ(result.ptr, last);
+
+    std::ostringstream stream;
+    stream << addr << ' ' << ipv6::loopback;
+    ASSERT_EQ(stream.str(), "192.168.1.254 ::1");
+}
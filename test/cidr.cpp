@@ -0,0 +1,83 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "gtest.hpp"
+#include <sstream>
+#include <libwire/cidr.hpp>
+#include <libwire/error.hpp>
+
+using namespace libwire;
+
+TEST(Cidr, Parse) {
+    std::error_code ec;
+    ASSERT_EQ(cidr::parse("10.0.0.0/8", ec), cidr({10, 0, 0, 0}, 8));
+    ASSERT_EQ(cidr::parse("192.168.1.77/24", ec), cidr({192, 168, 1, 0}, 24));
+    ASSERT_EQ(cidr::parse("0.0.0.0/0", ec), cidr(ipv4::any, 0));
+    ASSERT_EQ(cidr::parse("127.0.0.1", ec), cidr(ipv4::loopback, 32));
+    ASSERT_EQ(cidr::parse("2001:db8::/32", ec), cidr(address("2001:db8::"), 32));
+    ASSERT_EQ(cidr::parse("2001:db8:ffff::1/33", ec), cidr(address("2001:db8:8000::"), 33));
+    ASSERT_EQ(cidr::parse("::1/128", ec), cidr(ipv6::loopback, 128));
+    ASSERT_FALSE(ec);
+
+    for (const char* text : {"", "/8", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08", "10.0.0.0/-1", "10.0.0.0/8/8",
+                             "::/129", "::/1000", "10.0.0/8"}) {
+        ASSERT_TRUE(cidr::parse(text, ec).is_invalid()) << text;
+        ASSERT_EQ(ec, error::invalid_argument) << text;
+    }
+    ASSERT_THROW(cidr("10.0.0.0/33"), std::invalid_argument);
+    ASSERT_THROW(cidr::parse("10.0.0.0/33"), std::system_error);
+
+    // Error left from previous call is cleared.
+    ec = std::make_error_code(std::errc::timed_out);
+    ASSERT_EQ(cidr::parse("10.0.0.0/8", ec), cidr({10, 0, 0, 0}, 8));
+    ASSERT_FALSE(ec);
+}
+
+TEST(Cidr, Contains) {
+    cidr net("172.16.0.0/12");
+    ASSERT_TRUE(net.contains({172, 16, 0, 1}));
+    ASSERT_TRUE(net.contains({172, 31, 255, 255}));
+    ASSERT_FALSE(net.contains({172, 32, 0, 0}));
+    ASSERT_FALSE(net.contains(address("::ffff:172.16.0.1")));
+
+    ASSERT_TRUE(cidr("::/0").contains(ipv6::loopback));
+    ASSERT_TRUE(cidr("fe80::/10").contains(address("febf::1")));
+    ASSERT_FALSE(cidr("fe80::/10").contains(address("fec0::1")));
+}
+
+TEST(Cidr, ClampsLength) {
+    cidr net({10, 1, 2, 3}, 200);
+    ASSERT_EQ(net.prefix_length, 32);
+    ASSERT_TRUE(net.contains({10, 1, 2, 3}));
+    ASSERT_FALSE(net.contains({10, 1, 2, 4}));
+
+    ASSERT_EQ(cidr(ipv6::loopback, 255).prefix_length, 128);
+}
+
+TEST(Cidr, ToString) {
+    ASSERT_EQ(cidr("10.1.2.3/16").to_string(), "10.1.0.0/16");
+    ASSERT_EQ(cidr("2001:db8::/32").to_string(), "2001:db8::/32");
+
+    std::ostringstream stream;
+    stream << cidr("::1");
+    ASSERT_EQ(stream.str(), "::1/128");
+}
@@ -21,7 +21,11 @@
  */
 
 #include "gtest.hpp"
+#include <sstream>
+#include <unordered_set>
 #include <libwire/endpoint.hpp>
+#include <libwire/native_endpoint.hpp>
+#include <libwire/error.hpp>
 
 using namespace libwire;
 
@@ -60,4 +64,85 @@ TEST(IPv4Endpoint, ToString) {
 
 TEST(IPv6Endpoint, ToString) {
     ASSERT_EQ(endpoint(ipv6::loopback, 25565).to_string(), "[::1]:25565");
-}
\ No newline at end of file
+}
+
+TEST(IPv4Endpoint, Parse) {
+    std::error_code ec;
+    ASSERT_EQ(endpoint::parse("10.0.0.1:65535", ec), endpoint({10, 0, 0, 1}, 65535));
+    ASSERT_EQ(endpoint::parse("10.0.0.1:1", ec), endpoint({10, 0, 0, 1}, 1));
+    ASSERT_FALSE(ec);
+
+    for (const char* text : {"10.0.0.1:0", "10.0.0.1:65536", "10.0.0.1:100000", "10.0.0.1:-1", "10.0.0.1:80:80",
+                             "10.0.0:80"}) {
+        ASSERT_TRUE(endpoint::parse(text, ec).is_invalid()) << text;
+        ASSERT_EQ(ec, error::invalid_argument) << text;
+    }
+    ASSERT_THROW(endpoint::parse("10.0.0.1:"), std::system_error);
+
+    // Error left from previous call is cleared.
+    ec = std::make_error_code(std::errc::timed_out);
+    ASSERT_EQ(endpoint::parse("1.2.3.4:80", ec), endpoint({1, 2, 3, 4}, 80));
+    ASSERT_FALSE(ec);
+}
+
+TEST(IPv6Endpoint, Parse) {
+    std::error_code ec;
+    ASSERT_EQ(endpoint::parse("[::ffff:1.2.3.4]:443", ec),
+              endpoint({0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 1, 2, 3, 4}, 443));
+    ASSERT_FALSE(ec);
+
+    for (const char* text : {"[::1]", "[::1]80", "[::1:80", "[1.2.3.4]:80", "[::1]:"}) {
+        ASSERT_TRUE(endpoint::parse(text, ec).is_invalid()) << text;
+        ASSERT_EQ(ec, error::invalid_argument) << text;
+    }
+}
+
+TEST(Endpoint, ToChars) {
+    std::array<char, endpoint::max_text_length> buffer;
+    endpoint longest(address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), 65535);
+    auto result = longest.to_chars(buffer.data(), buffer.data() + buffer.size());
+    ASSERT_EQ(result.ec, std::errc());
+    ASSERT_EQ(std::string(buffer.data(), result.ptr), "[ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff]:65535");
+
+    endpoint ep(ipv6::loopback, 443);
+    result = ep.to_chars(buffer.data(), buffer.data() + 9);
+    ASSERT_EQ(result.ec, std::errc());
+    ASSERT_EQ(std::string(buffer.data(), result.ptr), "[::1]:443");
+
+    result = ep.to_chars(buffer.data(), buffer.data() + 8);
+    ASSERT_EQ(result.ec, std::errc::value_too_large);
+
+    std::ostringstream stream;
+    stream << endpoint(ipv4::loopback, 80) << ' ' << ep;
+    ASSERT_EQ(stream.str(), "127.0.0.1:80 [::1]:443");
+}
+
+TEST(Endpoint, Hash) {
+    std::hash<endpoint> hash;
+    ASSERT_EQ(hash(endpoint("[2001:db8::1]:53")), hash(endpoint(address("2001:db8::1"), 53)));
+    ASSERT_NE(hash(endpoint(ipv4::loopback, 1)), hash(endpoint(ipv4::loopback, 2)));
+    ASSERT_NE(hash(endpoint(ipv4::any, 1)), hash(endpoint(ipv6::any, 1)));
+
+    std::unordered_set<endpoint> set;
+    for (uint16_t port = 1; port <= 1000; ++port) {
+        set.emplace(ipv4::loopback, port);
+        set.emplace(ipv4::loopback, port);
+    }
+    ASSERT_EQ(set.size(), 1000u);
+}
+
+TEST(NativeEndpoint, Conversion) {
+    native_endpoint invalid;
+    ASSERT_TRUE(invalid.is_invalid());
+    ASSERT_EQ(invalid.size(), 0u);
+
+    for (const endpoint& ep : {endpoint("10.1.2.3:53"), endpoint("[2001:db8::1]:5353")}) {
+        native_endpoint native(ep);
+        ASSERT_FALSE(native.is_invalid());
+        ASSERT_EQ(native.version(), ep.addr.version);
+        ASSERT_EQ(native.to_endpoint(), ep);
+        ASSERT_EQ(native, native_endpoint(ep));
+        ASSERT_NE(native, native_endpoint(endpoint(ep.addr, 1)));
+    }
+    ASSERT_LT(native_endpoint(endpoint("10.1.2.3:53")).size(), native_endpoint(endpoint("[::1]:53")).size());
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "gtest.hpp"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <libwire/flat_map.hpp>
+
+using namespace libwire;
+
+namespace {
+    // Puts keys into few long clusters so shifting on removal and probing
+    // around the end of table are exercised.
+    struct clustering_hash {
+        size_t operator()(int key) const noexcept {
+            return (size_t(0) - 1 - size_t(key % 5) * 7) ^ (size_t(key) << (sizeof(size_t) * 8 - 3));
+        }
+    };
+
+    template<typename Map, typename Reference>
+    void expect_same(const Map& map, const Reference& reference) {
+        ASSERT_EQ(map.size(), reference.size());
+        size_t visited = 0;
+        for (const auto& [key, value] : map) {
+            auto it = reference.find(key);
+            ASSERT_NE(it, reference.end());
+            ASSERT_EQ(value, it->second);
+            ++visited;
+        }
+        ASSERT_EQ(visited, reference.size());
+        for (const auto& [key, value] : reference) {
+            auto it = map.find(key);
+            ASSERT_NE(it, map.end());
+            ASSERT_EQ(it->second, value);
+        }
+    }
+} // namespace
+
+TEST(FlatMap, Basic) {
+    endpoint_map<int> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.capacity(), 0u);
+    ASSERT_EQ(map.find(endpoint(ipv4::loopback, 1)), map.end());
+    ASSERT_EQ(map.erase(endpoint(ipv4::loopback, 1)), 0u);
+
+    ASSERT_TRUE(map.try_emplace(endpoint(ipv4::loopback, 1), 10).second);
+    ASSERT_FALSE(map.try_emplace(endpoint(ipv4::loopback, 1), 20).second);
+    map[endpoint(ipv6::loopback, 1)] = 30;
+    ASSERT_FALSE(map.insert_or_assign(endpoint(ipv6::loopback, 1), 40).second);
+
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.find(endpoint(ipv4::loopback, 1))->second, 10);
+    ASSERT_EQ(map[endpoint(ipv6::loopback, 1)], 40);
+    ASSERT_FALSE(map.contains(endpoint(ipv4::loopback, 2)));
+
+    map.erase(map.find(endpoint(ipv4::loopback, 1)));
+    ASSERT_EQ(map.size(), 1u);
+    ASSERT_EQ(map.count(endpoint(ipv4::loopback, 1)), 0u);
+
+    address_map<std::string> copy;
+    copy[ipv4::any] = "any";
+    auto moved = std::move(copy);
+    ASSERT_EQ(moved[ipv4::any], "any");
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(FlatMap, Reserve) {
+    endpoint_map<int> map(1000);
+    size_t capacity = map.capacity();
+    for (uint16_t port = 1; port <= 1000; ++port) map.try_emplace(endpoint(ipv4::loopback, port), port);
+    ASSERT_EQ(map.capacity(), capacity);
+    ASSERT_EQ(map.size(), 1000u);
+}
+
+TEST(FlatMap, MatchesUnorderedMap) {
+    flat_map<int, std::string, clustering_hash> map;
+    std::unordered_map<int, std::string> reference;
+    std::mt19937 random(42);
+
+    for (int step = 0; step < 20000; ++step) {
+        int key = int(random() % 200);
+        switch (random() % 4) {
+        case 0:
+        case 1:
+            ASSERT_EQ(map.try_emplace(key, std::to_string(step)).second,
+                      reference.try_emplace(key, std::to_string(step)).second);
+            break;
+        case 2:
+            ASSERT_EQ(map.erase(key), reference.erase(key));
+            break;
+        case 3:
+            map.insert_or_assign(key, std::to_string(step));
+            reference.insert_or_assign(key, std::to_string(step));
+            break;
+        }
+        if (step % 1000 == 0) expect_same(map, reference);
+    }
+    expect_same(map, reference);
+
+    auto copy = map;
+    expect_same(copy, reference);
+}
+
+TEST(FlatMap, EraseIf) {
+    flat_map<int, int, clustering_hash> map;
+    for (int i = 0; i < 100; ++i) map[i] = i;
+
+    size_t calls = 0;
+    auto removed = map.erase_if([&](const auto& value) {
+        ++calls;
+        return value.first % 3 == 0;
+    });
+    ASSERT_EQ(calls, 100u);
+    ASSERT_EQ(removed, 34u);
+    ASSERT_EQ(map.size(), 66u);
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(map.contains(i), i % 3 != 0) << i;
+}
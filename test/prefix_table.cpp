@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "gtest.hpp"
+#include <random>
+#include <vector>
+#include <libwire/prefix_table.hpp>
+
+using namespace libwire;
+
+namespace {
+    // Reference implementation: linear scan over all prefixes.
+    const int* brute_force_lookup(const std::vector<std::pair<cidr, int>>& prefixes, const address& addr) {
+        const std::pair<cidr, int>* best = nullptr;
+        for (const auto& entry : prefixes) {
+            if (entry.first.contains(addr) && (best == nullptr || entry.first.prefix_length > best->first.prefix_length)) {
+                best = &entry;
+            }
+        }
+        return best ? &best->second : nullptr;
+    }
+
+    address random_address(std::mt19937& random, ip version) {
+        address result;
+        result.version = version;
+        size_t size = version == ip::v4 ? 4 : 16;
+        // Few distinct values so prefixes overlap often.
+        for (size_t i = 0; i < size; ++i) result.parts[i] = uint8_t(random() % 4 == 0 ? random() : i);
+        return result;
+    }
+} // namespace
+
+TEST(PrefixTable, Basic) {
+    prefix_table<int> table;
+    ASSERT_EQ(table.lookup(ipv4::loopback), nullptr);
+
+    ASSERT_TRUE(table.insert_or_assign(cidr("10.0.0.0/8"), 1));
+    ASSERT_TRUE(table.insert_or_assign(cidr("10.66.0.0/16"), 2));
+    ASSERT_TRUE(table.insert_or_assign(cidr("10.66.1.1"), 3));
+    ASSERT_TRUE(table.insert_or_assign(cidr("::/0"), 4));
+    ASSERT_FALSE(table.insert_or_assign(cidr("10.0.0.0/8"), 5));
+    ASSERT_EQ(table.size(), 4u);
+
+    ASSERT_EQ(*table.lookup({10, 1, 2, 3}), 5);
+    ASSERT_EQ(*table.lookup({10, 66, 2, 3}), 2);
+    ASSERT_EQ(*table.lookup({10, 66, 1, 1}), 3);
+    ASSERT_EQ(table.lookup({11, 0, 0, 0}), nullptr);
+    ASSERT_EQ(*table.lookup(ipv6::loopback), 4);
+    ASSERT_EQ(*table.lookup(address("::ffff:10.66.1.1")), 3);
+
+    ASSERT_EQ(*table.find(cidr("10.66.0.0/16")), 2);
+    ASSERT_EQ(table.find(cidr("10.66.0.0/17")), nullptr);
+
+    ASSERT_TRUE(table.erase(cidr("10.66.0.0/16")));
+    ASSERT_FALSE(table.erase(cidr("10.66.0.0/16")));
+    ASSERT_EQ(*table.lookup({10, 66, 2, 3}), 5);
+    ASSERT_EQ(table.size(), 3u);
+
+    table.clear();
+    ASSERT_TRUE(table.empty());
+    ASSERT_EQ(table.lookup({10, 66, 1, 1}), nullptr);
+}
+
+TEST(PrefixTable, Bool) {
+    prefix_table<bool> allowed;
+    ASSERT_TRUE(allowed.insert_or_assign(cidr("10.0.0.0/8"), true));
+    ASSERT_TRUE(allowed.insert_or_assign(cidr("10.66.0.0/16"), false));
+
+    ASSERT_TRUE(*allowed.lookup({10, 1, 2, 3}));
+    ASSERT_FALSE(*allowed.lookup({10, 66, 2, 3}));
+    ASSERT_EQ(allowed.lookup({11, 0, 0, 0}), nullptr);
+
+    *allowed.find(cidr("10.66.0.0/16")) = true;
+    ASSERT_TRUE(*allowed.lookup({10, 66, 2, 3}));
+    ASSERT_TRUE(allowed.erase(cidr("10.0.0.0/8")));
+    ASSERT_EQ(allowed.lookup({10, 1, 2, 3}), nullptr);
+}
+
+TEST(PrefixTable, MatchesBruteForce) {
+    std::mt19937 random(7);
+    for (ip version : {ip::v4, ip::v6}) {
+        prefix_table<int> table;
+        std::vector<std::pair<cidr, int>> prefixes;
+        unsigned max_length = cidr::max_prefix_length(version);
+
+        for (int step = 0; step < 3000; ++step) {
+            cidr prefix(random_address(random, version), uint8_t(random() % (max_length + 1)));
+            auto it = std::find_if(prefixes.begin(), prefixes.end(), [&](const auto& e) { return e.first == prefix; });
+            if (random() % 3 == 0) {
+                ASSERT_EQ(table.erase(prefix), it != prefixes.end());
+                if (it != prefixes.end()) prefixes.erase(it);
+            } else {
+                ASSERT_EQ(table.insert_or_assign(prefix, step), it == prefixes.end());
+                if (it != prefixes.end()) {
+                    it->second = step;
+                } else {
+                    prefixes.emplace_back(prefix, step);
+                }
+            }
+
+            address probe = random_address(random, version);
+            const int* expected = brute_force_lookup(prefixes, probe);
+            const int* actual = table.lookup(probe);
+            ASSERT_EQ(actual == nullptr, expected == nullptr) << probe.to_string();
+            if (actual != nullptr) {
+                ASSERT_EQ(*actual, *expected) << probe.to_string();
+            }
+        }
+        ASSERT_EQ(table.size(), prefixes.size());
+        for (const auto& [prefix, value] : prefixes) ASSERT_EQ(*table.find(prefix), value);
+    }
+}
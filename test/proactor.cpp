@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "gtest.hpp"
+#include <libwire/proactor.hpp>
+#include <libwire/tcp.hpp>
+
+#if defined(LIBWIRE_LINUX) && defined(LIBWIRE_IO_URING)
+#    include <fcntl.h>
+
+using namespace std::literals::chrono_literals;
+using namespace libwire;
+
+static uint16_t port_to_use = 7777;
+
+struct Proactor : testing::Test {
+    void SetUp() override {
+        std::error_code ec;
+        p = std::make_unique<proactor>(ec);
+        // io_uring may be disabled by kernel configuration or sandbox.
+        if (ec) GTEST_SKIP() << "io_uring is not available: " << ec.message();
+    }
+
+    std::unique_ptr<proactor> p;
+};
+
+TEST_F(Proactor, TcpAcceptConnectReadWrite) {
+    tcp::listener listener({ipv4::loopback, port_to_use});
+    tcp::socket server, client;
+
+    bool accepted = false, connected = false;
+    p->async_accept(listener, [&](tcp::socket&& sock, const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        server = std::move(sock);
+        accepted = true;
+    });
+    p->async_connect(client, {ipv4::loopback, port_to_use}, [&](const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        connected = true;
+    });
+    // Both operations are submitted using one system call.
+    p->run();
+    ASSERT_TRUE(accepted);
+    ASSERT_TRUE(connected);
+    ASSERT_EQ(p->pending(), 0);
+    ASSERT_EQ(server.remote_endpoint(), client.local_endpoint());
+    ASSERT_NE(fcntl(server.native_handle(), F_GETFD) & FD_CLOEXEC, 0);
+    ASSERT_NE(fcntl(client.native_handle(), F_GETFD) & FD_CLOEXEC, 0);
+
+    std::string out = "Hello, io_uring!";
+    std::string in(out.size(), '\0');
+    size_t written = 0, readen = 0;
+    p->async_write(client, out, [&](size_t bytes, const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        written = bytes;
+    });
+    p->async_read(server, in, [&](size_t bytes, const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        readen = bytes;
+    });
+    p->run();
+    ASSERT_EQ(written, out.size());
+    ASSERT_EQ(readen, out.size());
+    ASSERT_EQ(in, out);
+
+    server.set_option(tcp::linger, true, 0s);
+    client.set_option(tcp::linger, true, 0s);
+}
+
+TEST_F(Proactor, TcpEndOfFile) {
+    tcp::listener listener({ipv4::loopback, port_to_use});
+    tcp::socket client;
+    client.connect({ipv4::loopback, port_to_use});
+    tcp::socket server = listener.accept();
+    client.close();
+
+    std::vector<uint8_t> buf(16);
+    std::error_code result;
+    p->async_read(server, buf, [&](size_t, const std::error_code& ec) { result = ec; });
+    p->run();
+    ASSERT_EQ(result, error::end_of_file);
+}
+
+TEST_F(Proactor, UdpReadFromWriteTo) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+
+    std::vector<uint8_t> out{1, 2, 3, 4}, in(16);
+    endpoint source = endpoint::invalid;
+    size_t readen = 0;
+    p->async_read_from(receiver, in, [&](size_t bytes, const endpoint& src, const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        readen = bytes;
+        source = src;
+    });
+    p->async_write_to(sender, out, {ipv4::loopback, port_to_use}, [&](size_t bytes, const std::error_code& ec) {
+        ASSERT_FALSE(ec);
+        ASSERT_EQ(bytes, out.size());
+    });
+    p->run();
+
+    ASSERT_EQ(readen, out.size());
+    in.resize(readen);
+    ASSERT_EQ(in, out);
+    ASSERT_EQ(source.port, sender.implementation().local_endpoint().port);
+}
+
+TEST_F(Proactor, ConnectRefused) {
+    tcp::socket sock;
+    std::error_code result;
+    p->async_connect(sock, {ipv4::loopback, 65500}, [&](const std::error_code& ec) { result = ec; });
+    p->run();
+    ASSERT_EQ(result, error::connection_refused);
+}
+
+TEST_F(Proactor, DestroyCancelsPending) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+
+    auto in = std::make_unique<std::vector<uint8_t>>(16);
+    bool called = false;
+    p->async_read_from(receiver, *in, [&](size_t, const endpoint&, const std::error_code&) { called = true; });
+    p->run_once(0ms); // Submit.
+    ASSERT_EQ(p->pending(), 1);
+    p.reset();
+    in.reset();
+    ASSERT_FALSE(called);
+
+    // Read was cancelled, not left to complete into freed buffer.
+    std::vector<uint8_t> out{1, 2, 3, 4}, buffer;
+    sender.write(out, {ipv4::loopback, port_to_use});
+    receiver.read(16, buffer);
+    ASSERT_EQ(buffer, out);
+}
+
+#endif // if defined(LIBWIRE_LINUX) && defined(LIBWIRE_IO_URING)
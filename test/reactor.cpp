@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <thread>
+#include <chrono>
+#include "gtest.hpp"
+#include <libwire/reactor.hpp>
+#include <libwire/tcp.hpp>
+#include <libwire/udp.hpp>
+
+#if defined(LIBWIRE_LINUX)
+
+using namespace std::literals::chrono_literals;
+using namespace libwire;
+
+static uint16_t port_to_use = 7777;
+
+TEST(Reactor, UdpReadable) {
+    reactor r;
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+
+    unsigned calls = 0;
+    r.add(receiver, reactor::readable, [&](unsigned events) {
+        ASSERT_TRUE(events & reactor::readable);
+        std::error_code ec;
+        // Drain socket until would block, as required by edge-triggered mode.
+        while (receiver.read(16, ec), !ec) ++calls;
+        ASSERT_EQ(ec, error::try_again);
+    });
+    ASSERT_TRUE(receiver.option(non_blocking));
+
+    // Nothing sent yet.
+    ASSERT_EQ(r.run_once(0ms), 0);
+
+    sender.write(std::vector<uint8_t>{1, 2, 3, 4}, {ipv4::loopback, port_to_use});
+    sender.write(std::vector<uint8_t>{5, 6, 7, 8}, {ipv4::loopback, port_to_use});
+    ASSERT_EQ(r.run_once(1s), 1);
+    ASSERT_EQ(calls, 2);
+}
+
+TEST(Reactor, TcpAcceptAndRemove) {
+    reactor r;
+    tcp::listener listener({ipv4::loopback, port_to_use});
+    tcp::socket server, client;
+
+    r.add(listener, reactor::readable, [&](unsigned) {
+        std::error_code ec;
+        server = listener.accept(ec);
+        ASSERT_FALSE(ec);
+        r.remove(listener);
+    });
+
+    client.connect({ipv4::loopback, port_to_use});
+    client.set_option(tcp::linger, true, 0s);
+    ASSERT_EQ(r.run_once(1s), 1);
+    ASSERT_TRUE(server.is_open());
+    ASSERT_EQ(r.size(), 0);
+
+    bool hangup = false;
+    r.add(server, reactor::readable, [&](unsigned events) {
+        hangup = (events & reactor::hangup) != 0;
+        r.remove(server);
+    });
+    client.close();
+    ASSERT_EQ(r.run_once(1s), 1);
+    ASSERT_TRUE(hangup);
+}
+
+TEST(Reactor, StopFromOtherThread) {
+    reactor r;
+    std::thread stopper([&]() {
+        std::this_thread::sleep_for(100ms);
+        r.stop();
+    });
+    r.run();
+    stopper.join();
+}
+
+TEST(Reactor, StopBeforeRun) {
+    reactor r;
+    r.stop();
+    r.run(); // Returns immediately.
+
+    // Flag is reset after run returned.
+    std::thread stopper([&]() {
+        std::this_thread::sleep_for(100ms);
+        r.stop();
+    });
+    auto start = std::chrono::steady_clock::now();
+    r.run();
+    ASSERT_GE(std::chrono::steady_clock::now() - start, 50ms);
+    stopper.join();
+}
+
+#endif // if defined(LIBWIRE_LINUX)
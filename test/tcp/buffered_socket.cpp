@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <thread>
+#include <chrono>
+#include "../gtest.hpp"
+#include <libwire/tcp.hpp>
+
+using namespace std::literals::chrono_literals;
+
+static uint16_t port_to_use = 7777;
+
+using namespace libwire;
+
+struct TcpBufferedSocketPair : testing::TestWithParam<address> {
+    void SetUp() override {
+        listener.listen({GetParam(), port_to_use});
+        std::thread connect_thr([&]() {
+            std::this_thread::sleep_for(100ms);
+            client.connect({GetParam(), port_to_use});
+        });
+
+        server = tcp::buffered_socket(listener.accept(), 64);
+        if (connect_thr.joinable()) connect_thr.join();
+
+        server.next_layer().set_option(tcp::linger, true, 0s);
+        client.set_option(tcp::linger, true, 0s);
+    }
+
+    void TearDown() override {
+        if (client.is_open()) client.shutdown();
+        if (server.next_layer().is_open()) server.next_layer().shutdown();
+        listener = tcp::listener();
+    }
+
+    tcp::listener listener;
+    tcp::buffered_socket server;
+    tcp::socket client;
+};
+
+TEST_P(TcpBufferedSocketPair, ReadUntilLines) {
+    client.write(std::string("first\nsecond\nthird\n"));
+
+    ASSERT_EQ(server.read_until<std::string>('\n'), "first");
+    // Everything else should be already buffered.
+    ASSERT_EQ(server.buffered(), 13);
+    ASSERT_EQ(server.read_until<std::string>('\n'), "second");
+    ASSERT_EQ(server.read_until<std::string>('\n'), "third");
+    ASSERT_EQ(server.buffered(), 0);
+}
+
+TEST_P(TcpBufferedSocketPair, ReadUntilLongerThanBuffer) {
+    std::string line(1000, 'a');
+    client.write(line + '\n');
+
+    ASSERT_EQ(server.read_until<std::string>('\n'), line);
+}
+
+TEST_P(TcpBufferedSocketPair, ReadUntilMaxSize) {
+    client.write(std::string("abcdef\n"));
+
+    ASSERT_EQ(server.read_until<std::string>('\n', 4), "abcd");
+    // Limit reached, rest must be left in stream.
+    ASSERT_EQ(server.read_until<std::string>('\n'), "ef");
+}
+
+TEST_P(TcpBufferedSocketPair, ReadExactlyIntegrityCheck) {
+    for (unsigned i = 0; i < 10; ++i) {
+        auto vec = std::vector<uint8_t>(1024 * (i + 1), uint8_t(i));
+
+        client.write(vec);
+        auto vec2 = server.read_exactly(vec.size());
+        ASSERT_EQ(vec, vec2);
+    }
+}
+
+TEST_P(TcpBufferedSocketPair, MixedReads) {
+    client.write(std::string("header\n0123456789"));
+
+    ASSERT_EQ(server.read_until<std::string>('\n'), "header");
+    ASSERT_EQ(server.read_exactly<std::string>(4), "0123");
+    auto rest = server.read<std::string>(100);
+    ASSERT_EQ(rest, "456789");
+}
+
+TEST_P(TcpBufferedSocketPair, EndOfFile) {
+    client.write(std::string("partial"));
+    client.shutdown();
+
+    std::error_code ec;
+    auto res = server.read_until<std::string>('\n', ec);
+    ASSERT_EQ(ec, error::end_of_file);
+    ASSERT_EQ(res, "partial");
+}
+
+INSTANTIATE_TEST_CASE_P(Ipv4, TcpBufferedSocketPair, ::testing::Values(ipv4::loopback));
+INSTANTIATE_TEST_CASE_P(Ipv6, TcpBufferedSocketPair, ::testing::Values(ipv6::loopback));
@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <chrono>
+#include "../gtest.hpp"
+#include <libwire/tcp.hpp>
+#include <libwire/options.hpp>
+
+using namespace std::literals::chrono_literals;
+
+static uint16_t port_to_use = 7777;
+
+using namespace libwire;
+
+/**
+ * Two connections, data written to source_peer is relayed from source
+ * to destination and received by destination_peer.
+ */
+struct TcpForward : testing::TestWithParam<address> {
+    void SetUp() override {
+        listener.listen({GetParam(), port_to_use});
+        connect_pair(source_peer, source);
+        connect_pair(destination, destination_peer);
+    }
+
+    void TearDown() override {
+        for (tcp::socket* sock : {&source_peer, &source, &destination, &destination_peer}) {
+            if (sock->is_open()) sock->shutdown();
+        }
+        listener = tcp::listener();
+    }
+
+    void connect_pair(tcp::socket& client, tcp::socket& server) {
+        std::thread connect_thr([&]() {
+            std::this_thread::sleep_for(100ms);
+            client.connect({GetParam(), port_to_use});
+        });
+        server = listener.accept();
+        if (connect_thr.joinable()) connect_thr.join();
+
+        server.set_option(tcp::linger, true, 0s);
+        client.set_option(tcp::linger, true, 0s);
+    }
+
+    static std::vector<uint8_t> pattern(size_t size) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = uint8_t(i * 13);
+        return data;
+    }
+
+    tcp::listener listener;
+    tcp::socket source_peer, source, destination, destination_peer;
+};
+
+TEST_P(TcpForward, BlockingUntilHalfClose) {
+    auto data = pattern(4 * 1024 * 1024);
+    std::thread writer([&]() {
+        source_peer.write(data);
+        source_peer.shutdown(false, true);
+    });
+    std::vector<uint8_t> received;
+    std::thread reader([&]() {
+        received = destination_peer.read(data.size());
+    });
+
+    tcp::forward_buffer buffer;
+    auto result = tcp::forward(source, destination, buffer);
+    writer.join();
+    reader.join();
+
+    ASSERT_EQ(result.bytes, data.size());
+    ASSERT_TRUE(result.half_closed);
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(received, data);
+
+    // Half-close is propagated to destination peer.
+    std::error_code ec;
+    destination_peer.read(1, ec);
+    ASSERT_EQ(ec, error::end_of_file);
+
+    // Other direction is still usable.
+    destination_peer.write(std::string("back"));
+    ASSERT_EQ(destination.read<std::string>(4), "back");
+}
+
+TEST_P(TcpForward, NonBlocking) {
+    source.set_option(non_blocking, true);
+    destination.set_option(non_blocking, true);
+
+    std::error_code ec;
+    tcp::forward_buffer buffer;
+    auto result = tcp::forward(source, destination, buffer, ec);
+    ASSERT_EQ(ec, error::would_block);
+    ASSERT_EQ(result.bytes, 0);
+    ASSERT_FALSE(result.half_closed);
+
+    // Large enough to fill destination buffers, so both sides block.
+    auto data = pattern(16 * 1024 * 1024);
+    std::thread writer([&]() {
+        source_peer.write(data);
+    });
+    std::vector<uint8_t> received;
+    std::thread reader([&]() {
+        std::this_thread::sleep_for(100ms);
+        received = destination_peer.read(data.size());
+    });
+
+    uint64_t total = 0;
+    while (total != data.size()) {
+        total += tcp::forward(source, destination, buffer, ec).bytes;
+        if (ec) {
+            ASSERT_EQ(ec, error::would_block);
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    writer.join();
+    reader.join();
+    ASSERT_EQ(received, data);
+}
+
+TEST_P(TcpForward, MaxBytes) {
+    auto data = pattern(1000);
+    source_peer.write(data);
+
+    tcp::forward_buffer buffer;
+    auto result = tcp::forward(source, destination, buffer, 600);
+    ASSERT_EQ(result.bytes, 600);
+    ASSERT_FALSE(result.half_closed);
+
+    result = tcp::forward(source, destination, buffer, 400);
+    ASSERT_EQ(result.bytes, 400);
+    ASSERT_EQ(destination_peer.read(data.size()), data);
+}
+
+TEST_P(TcpForward, DestinationClosed) {
+    destination_peer.close();
+    std::this_thread::sleep_for(50ms);
+
+    // Process must not be killed by SIGPIPE.
+    auto data = pattern(64 * 1024);
+    std::error_code ec;
+    tcp::forward_buffer buffer;
+    for (int i = 0; i < 10 && !ec; ++i) {
+        source_peer.write(data);
+        tcp::forward(source, destination, buffer, ec);
+    }
+    ASSERT_EQ(ec, error::generic::disconnected);
+    ASSERT_FALSE(destination.is_open());
+    ASSERT_TRUE(source.is_open());
+}
+
+INSTANTIATE_TEST_CASE_P(Ipv4, TcpForward, ::testing::Values(ipv4::loopback));
+INSTANTIATE_TEST_CASE_P(Ipv6, TcpForward, ::testing::Values(ipv6::loopback));
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "../gtest.hpp"
+#include <libwire/tcp.hpp>
+#include <libwire/options.hpp>
+
+using namespace std::literals::chrono_literals;
+using namespace libwire;
+
+TEST(TcpListenerGroup, SharedEndpoint) {
+    tcp::listener_group group({ipv4::loopback, 0}, 4);
+    ASSERT_EQ(group.size(), 4);
+    endpoint target = group.local_endpoint();
+    ASSERT_NE(target.port, 0);
+    for (const tcp::listener& l : group) {
+        ASSERT_EQ(l.local_endpoint(), target);
+    }
+
+    // Listener without SO_REUSEPORT can't join the group.
+    std::error_code ec;
+    tcp::listener intruder(target, ec);
+    ASSERT_EQ(ec, error::already_in_use);
+}
+
+TEST(TcpListenerGroup, Empty) {
+    tcp::listener_group group;
+    ASSERT_EQ(group.local_endpoint(), endpoint::invalid);
+
+    std::error_code ec = std::make_error_code(std::errc::timed_out);
+    group.listen({ipv4::loopback, 0}, 0, ec);
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(group.size(), 0);
+    ASSERT_EQ(group.local_endpoint(), endpoint::invalid);
+}
+
+TEST(TcpListenerGroup, ConnectionsDistributed) {
+    tcp::listener_group group({ipv4::loopback, 0}, 4);
+    group.set_accept_non_blocking(true);
+
+    std::vector<tcp::socket> clients(32);
+    for (tcp::socket& client : clients) {
+        client.connect(group.local_endpoint());
+        client.set_option(tcp::linger, true, 0s);
+    }
+
+    size_t accepted = 0, used_listeners = 0;
+    for (tcp::listener& l : group) {
+        non_blocking.set(l, true);
+        size_t accepted_here = 0;
+        for (;;) {
+            std::error_code ec;
+            tcp::socket server = l.accept(ec);
+            if (ec) {
+                ASSERT_EQ(ec, error::would_block);
+                break;
+            }
+            server.set_option(tcp::linger, true, 0s);
+            ++accepted_here;
+        }
+        accepted += accepted_here;
+        if (accepted_here != 0) ++used_listeners;
+    }
+    ASSERT_EQ(accepted, clients.size());
+    ASSERT_GT(used_listeners, 1);
+}
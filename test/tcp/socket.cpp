@@ -20,10 +20,16 @@
  * SOFTWARE.
  */
 
+#include <cstdio>
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include "../gtest.hpp"
 #include <libwire/tcp.hpp>
+#include <libwire/options.hpp>
+#if defined(LIBWIRE_POSIX)
+#    include <fcntl.h>
+#endif
 
 using namespace std::literals::chrono_literals;
 
@@ -71,6 +77,16 @@ TEST_P(TcpSocketPair, EndpointsConsistency) {
     ASSERT_EQ(server.remote_endpoint(), client.local_endpoint());
 }
 
+TEST_P(TcpSocketPair, RemoteEndpointCached) {
+    // Accepted and connected sockets remember remote endpoint,
+    // so it's still available after connection is shut down.
+    endpoint client_endpoint = client.local_endpoint();
+    client.shutdown();
+    server.shutdown();
+    ASSERT_EQ(server.remote_endpoint(), client_endpoint);
+    ASSERT_EQ(client.remote_endpoint(), endpoint(GetParam(), 7777));
+}
+
 TEST_P(TcpSocketPair, BasicIntegrityCheck) {
     for (unsigned i = 0; i < 10; ++i) {
         auto vec = std::vector<uint8_t>(1024 * (i + 1), 0x00);
@@ -92,6 +108,116 @@ TEST_P(TcpSocketPair, ReadUntilIntegrityCheck) {
     }
 }
 
+TEST_P(TcpSocketPair, GatherWriteScatterRead) {
+    uint32_t header = 0xDEADBEEF;
+    std::vector<uint8_t> payload(64 * 1024, 0xAB);
+
+    size_t written = client.write({memory_view(&header, sizeof(header)),
+                                   memory_view(payload.data(), payload.size())});
+    ASSERT_EQ(written, sizeof(header) + payload.size());
+
+    uint32_t received_header = 0;
+    std::vector<uint8_t> received_payload(payload.size());
+    std::vector<memory_view> buffers{memory_view(&received_header, sizeof(received_header)),
+                                     memory_view(received_payload.data(), received_payload.size())};
+    size_t readen = server.read(buffers);
+    ASSERT_EQ(readen, written);
+    ASSERT_EQ(received_header, header);
+    ASSERT_EQ(received_payload, payload);
+}
+
+TEST_P(TcpSocketPair, NonBlockingReadSome) {
+    server.set_option(non_blocking, true);
+
+    std::vector<uint8_t> buf(16);
+    std::error_code ec;
+    ASSERT_EQ(server.read_some(buf, ec), 0);
+    ASSERT_EQ(ec, error::would_block);
+    ASSERT_TRUE(server.is_open());
+
+    client.write(std::vector<uint8_t>{1, 2, 3, 4});
+    std::this_thread::sleep_for(50ms);
+    ASSERT_EQ(server.read_some(buf, ec), 4);
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(buf[3], 4);
+}
+
+TEST_P(TcpSocketPair, NonBlockingReadKeepsPartialData) {
+    server.set_option(non_blocking, true);
+
+    client.write(std::vector<uint8_t>{1, 2, 3, 4});
+    std::this_thread::sleep_for(50ms);
+
+    std::error_code ec;
+    auto buf = server.read(8, ec);
+    ASSERT_EQ(ec, error::would_block);
+    ASSERT_EQ(buf, (std::vector<uint8_t>{1, 2, 3, 4}));
+}
+
+TEST_P(TcpSocketPair, NonBlockingWriteAll) {
+    client.set_option(non_blocking, true);
+
+    // Large enough to fill both send and receive buffers.
+    std::vector<uint8_t> data(16 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = uint8_t(i);
+
+    std::error_code ec;
+    size_t offset = client.write_all(data, ec);
+    ASSERT_EQ(ec, error::would_block);
+    ASSERT_LT(offset, data.size());
+
+    std::thread reader([&]() {
+        auto received = server.read(data.size());
+        ASSERT_EQ(received, data);
+    });
+    while (offset != data.size()) {
+        offset = client.write_all(data, ec, offset);
+        if (ec) {
+            ASSERT_EQ(ec, error::would_block);
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    reader.join();
+}
+
+TEST_P(TcpSocketPair, SendFile) {
+    std::vector<uint8_t> data(4 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = uint8_t(i * 7);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fwrite(data.data(), 1, data.size(), file), data.size());
+    ASSERT_EQ(std::fflush(file), 0);
+
+    // Send everything except first 100 bytes in non-blocking mode.
+    client.set_option(non_blocking, true);
+    const uint64_t offset = 100, length = data.size() - offset;
+    std::thread reader([&]() {
+        auto received = server.read(length);
+        ASSERT_TRUE(std::equal(received.begin(), received.end(), data.begin() + offset));
+    });
+    std::error_code ec;
+    uint64_t sent = 0;
+    while (sent != length) {
+        sent += client.send_file(fileno(file), offset + sent, length - sent, ec);
+        if (ec) {
+            ASSERT_EQ(ec, error::would_block);
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    reader.join();
+
+    // File is shorter than requested.
+    client.set_option(non_blocking, false);
+    ASSERT_EQ(client.send_file(fileno(file), data.size() - 10, 20, ec), 10);
+    ASSERT_EQ(ec, error::end_of_file);
+    ASSERT_TRUE(client.is_open());
+    auto tail = server.read(10);
+    ASSERT_TRUE(std::equal(tail.begin(), tail.end(), data.end() - 10));
+
+    std::fclose(file);
+}
+
 INSTANTIATE_TEST_CASE_P(Ipv4, TcpSocketPair, ::testing::Values(ipv4::loopback));
 INSTANTIATE_TEST_CASE_P(Ipv6, TcpSocketPair, ::testing::Values(ipv6::loopback));
 
@@ -107,3 +233,58 @@ TEST(TcpSocket, Errors) {
         ASSERT_EQ(ec, error::connection_refused);
     }
 }
+
+TEST(TcpListener, AcceptNonBlocking) {
+    tcp::listener listener({ipv4::loopback, port_to_use});
+    ASSERT_FALSE(listener.accept_non_blocking());
+    listener.set_accept_non_blocking(true);
+    ASSERT_TRUE(listener.accept_non_blocking());
+
+    tcp::socket client;
+    client.connect({ipv4::loopback, port_to_use});
+    tcp::socket server = listener.accept();
+    ASSERT_TRUE(server.option(non_blocking));
+    ASSERT_FALSE(client.option(non_blocking));
+
+    std::error_code ec;
+    std::vector<uint8_t> buffer(16);
+    server.read_some(buffer, ec);
+    ASSERT_EQ(ec, error::would_block);
+
+    server.set_option(tcp::linger, true, 0s);
+    client.set_option(tcp::linger, true, 0s);
+}
+
+#if defined(LIBWIRE_POSIX)
+TEST(TcpListener, CreationFlags) {
+    auto close_on_exec = [](auto& sock) { return (fcntl(sock.native_handle(), F_GETFD) & FD_CLOEXEC) != 0; };
+    auto non_blocking = [](auto& sock) { return (fcntl(sock.native_handle(), F_GETFL) & O_NONBLOCK) != 0; };
+
+    tcp::listener listener({ipv4::loopback, port_to_use});
+    ASSERT_TRUE(close_on_exec(listener));
+
+    tcp::socket client;
+    client.connect({ipv4::loopback, port_to_use});
+    ASSERT_TRUE(close_on_exec(client));
+    ASSERT_FALSE(non_blocking(client));
+
+    tcp::socket blocking_server = listener.accept();
+    ASSERT_TRUE(close_on_exec(blocking_server));
+    ASSERT_FALSE(non_blocking(blocking_server));
+
+    listener.set_accept_non_blocking(true);
+    tcp::socket second_client;
+    second_client.connect({ipv4::loopback, port_to_use});
+    tcp::socket server = listener.accept();
+    ASSERT_TRUE(close_on_exec(server));
+    ASSERT_TRUE(non_blocking(server));
+
+    // Moving keeps flag known to libwire.
+    tcp::socket moved = std::move(server);
+    ASSERT_TRUE(moved.implementation().state.user_non_blocking);
+
+    for (tcp::socket* sock : {&client, &blocking_server, &second_client, &moved}) {
+        sock->set_option(tcp::linger, true, 0s);
+    }
+}
+#endif // if defined(LIBWIRE_POSIX)
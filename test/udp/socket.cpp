@@ -20,9 +20,14 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <chrono>
 #include "../gtest.hpp"
 #include <libwire/udp.hpp>
 #include <libwire/options.hpp>
+#if defined(LIBWIRE_POSIX)
+#    include <fcntl.h>
+#endif
 
 using namespace libwire;
 static uint16_t port_to_use = 7777;
@@ -41,6 +46,24 @@ TEST(UDPSocket, Integrity) {
     ASSERT_EQ(buffer, buffer2);
 }
 
+TEST(UDPSocket, NonBlockingConstructor) {
+    udp::socket sock(ip::v4, non_blocking);
+    ASSERT_TRUE(sock.option(non_blocking));
+    ASSERT_FALSE(udp::socket(ip::v4).option(non_blocking));
+
+#if defined(LIBWIRE_POSIX)
+    ASSERT_NE(fcntl(sock.native_handle(), F_GETFL) & O_NONBLOCK, 0);
+    ASSERT_NE(fcntl(sock.native_handle(), F_GETFD) & FD_CLOEXEC, 0);
+#endif
+
+    std::error_code ec;
+    std::vector<uint8_t> buffer(16);
+    sock.listen({ipv4::loopback, 0}, ec);
+    ASSERT_FALSE(ec);
+    sock.read(buffer.size(), buffer, ec);
+    ASSERT_EQ(ec, error::would_block);
+}
+
 TEST(UDPSocket, TruncatedDatagram) {
     // Here we check if datagram is correctly truncated
     // when receiver buffer is too small.
@@ -108,4 +131,236 @@ TEST(UDPSocket, Disassociate) {
     sender.disassociate();
     // Ouch! No association and no explicit destination
     ASSERT_THROW(sender.write(std::vector<uint8_t>{1,2,3,4}), std::system_error);
-}
\ No newline at end of file
+}
+TEST(UDPSocket, Batch) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<udp::datagram> outgoing;
+    for (uint8_t i = 1; i <= 8; ++i) {
+        payloads.emplace_back(i * 16, i);
+    }
+    for (auto& payload : payloads) {
+        outgoing.emplace_back(memory_view(payload.data(), payload.size()), endpoint(ipv4::loopback, port_to_use));
+    }
+    ASSERT_EQ(sender.write_batch(outgoing), outgoing.size());
+    for (size_t i = 0; i < outgoing.size(); ++i) {
+        ASSERT_EQ(outgoing[i].size, payloads[i].size());
+    }
+
+    // Last buffer is too small and should be truncated.
+    std::vector<std::vector<uint8_t>> buffers(payloads.size(), std::vector<uint8_t>(128));
+    buffers.back().resize(64);
+    std::vector<udp::datagram> incoming;
+    for (auto& buffer : buffers) {
+        incoming.emplace_back(memory_view(buffer.data(), buffer.size()));
+    }
+
+    receiver.set_option(non_blocking, true);
+    size_t received = 0;
+    while (received < incoming.size()) {
+        received += receiver.read_batch(incoming.data() + received, incoming.size() - received);
+    }
+
+    for (size_t i = 0; i < incoming.size(); ++i) {
+        ASSERT_FALSE(incoming[i].ec);
+        ASSERT_EQ(incoming[i].peer.addr, ipv4::loopback);
+        if (i + 1 != incoming.size()) {
+            ASSERT_FALSE(incoming[i].truncated);
+            ASSERT_EQ(incoming[i].size, payloads[i].size());
+            buffers[i].resize(incoming[i].size);
+            ASSERT_EQ(buffers[i], payloads[i]);
+        } else {
+            ASSERT_TRUE(incoming[i].truncated);
+            ASSERT_EQ(incoming[i].size, 64);
+        }
+    }
+
+    std::error_code ec;
+    ASSERT_EQ(receiver.read_batch(incoming, ec), 0);
+    ASSERT_EQ(ec, error::would_block);
+    ASSERT_EQ(incoming[0].ec, error::would_block);
+}
+
+TEST(UDPSocket, NativeEndpoint) {
+    udp::socket server(ip::v4), client(ip::v4);
+    server.listen({ipv4::loopback, port_to_use});
+    client.listen({ipv4::loopback, uint16_t(port_to_use + 1)});
+
+    native_endpoint server_endpoint(endpoint(ipv4::loopback, port_to_use));
+    ASSERT_EQ(server_endpoint.to_endpoint(), endpoint(ipv4::loopback, port_to_use));
+
+    std::vector<uint8_t> request(32, 0x42), buffer;
+    client.write(request, server_endpoint);
+
+    // Reply to source of request without converting its address.
+    native_endpoint source;
+    server.read(128, buffer, source);
+    ASSERT_EQ(buffer, request);
+    ASSERT_EQ(source.to_endpoint(), endpoint(ipv4::loopback, uint16_t(port_to_use + 1)));
+    ASSERT_EQ(source, native_endpoint(endpoint(ipv4::loopback, uint16_t(port_to_use + 1))));
+    server.write(buffer, source);
+
+    ASSERT_EQ(client.read(128), request);
+}
+
+TEST(UDPSocket, WriteSegmented) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+
+    // Large enough to be split into more than one offloaded send.
+    const size_t segment_size = 1400, segments = 60, tail = 300;
+    std::vector<uint8_t> payload(segment_size * segments + tail);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = uint8_t(i / segment_size);
+
+    ASSERT_EQ(sender.write_segmented(payload, segment_size, {ipv4::loopback, port_to_use}), payload.size());
+
+    std::vector<uint8_t> buffer;
+    receiver.set_option(non_blocking, true);
+    for (size_t i = 0; i <= segments; ++i) {
+        receiver.read(segment_size * 2, buffer);
+        size_t offset = i * segment_size;
+        ASSERT_EQ(buffer.size(), i == segments ? tail : segment_size);
+        ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), payload.begin() + ptrdiff_t(offset)));
+    }
+
+    // Destination set by associate is used too.
+    sender.associate({ipv4::loopback, port_to_use});
+    ASSERT_EQ(sender.write_segmented(std::string("abcdefg"), 3), 7);
+    ASSERT_EQ(receiver.read<std::string>(16), "abc");
+    ASSERT_EQ(receiver.read<std::string>(16), "def");
+    ASSERT_EQ(receiver.read<std::string>(16), "g");
+
+    std::error_code ec;
+    ASSERT_EQ(sender.write_segmented(std::string("abc"), 0, ec), 0);
+    ASSERT_EQ(ec, error::invalid_argument);
+}
+
+TEST(UDPSocket, ReadCoalesced) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+    receiver.set_option(udp::receive_offload, true);
+
+    const size_t segment_size = 1000, segments = 20, tail = 300;
+    std::vector<uint8_t> payload(segment_size * segments + tail);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = uint8_t(i / segment_size);
+    sender.write_segmented(payload, segment_size, {ipv4::loopback, port_to_use});
+
+    // Datagrams may be coalesced or not, but must be split back exactly.
+    std::vector<uint8_t> buffer(64 * 1024);
+    size_t received = 0, offset = 0;
+    while (received <= segments) {
+        endpoint source = endpoint::invalid;
+        auto datagrams = receiver.read_coalesced({buffer.data(), buffer.size()}, &source);
+        ASSERT_FALSE(datagrams.truncated);
+        ASSERT_EQ(source, endpoint(ipv4::loopback, sender.implementation().local_endpoint().port));
+        for (memory_view datagram : datagrams) {
+            ASSERT_EQ(datagram.size(), received == segments ? tail : segment_size);
+            ASSERT_TRUE(std::equal(datagram.begin(), datagram.end(), payload.begin() + ptrdiff_t(offset)));
+            offset += datagram.size();
+            ++received;
+        }
+    }
+    ASSERT_EQ(offset, payload.size());
+
+    // Without offload every datagram is returned separately.
+    receiver.set_option(udp::receive_offload, false);
+    ASSERT_FALSE(receiver.option(udp::receive_offload));
+    sender.write_segmented(payload, segment_size, {ipv4::loopback, port_to_use});
+    auto datagrams = receiver.read_coalesced({buffer.data(), buffer.size()});
+    ASSERT_EQ(datagrams.count(), 1);
+    ASSERT_EQ(datagrams.segment_size, segment_size);
+}
+
+TEST(UDPSocket, ReadCoalescedWithTimestamp) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+    receiver.set_option(udp::receive_offload, true);
+    // Timestamp control message comes first and must not push out UDP_GRO.
+    receiver.set_option(udp::receive_timestamp, true);
+    receiver.set_option(udp::receive_drop_count, true);
+    receiver.set_option(udp::receive_packet_info, true);
+
+    const size_t segment_size = 100, segments = 10;
+    std::vector<uint8_t> payload(segment_size * segments, 0xAB);
+    sender.write_segmented(payload, segment_size, {ipv4::loopback, port_to_use});
+
+    std::vector<uint8_t> buffer(64 * 1024);
+    size_t received = 0;
+    while (received < segments) {
+        auto datagrams = receiver.read_coalesced({buffer.data(), buffer.size()});
+        ASSERT_EQ(datagrams.segment_size, segment_size);
+        for (memory_view datagram : datagrams) {
+            ASSERT_EQ(datagram.size(), segment_size);
+            ++received;
+        }
+    }
+    ASSERT_EQ(received, segments);
+}
+
+TEST(UDPSocket, PacketInfo) {
+    udp::socket server(ip::v4), client(ip::v4);
+    server.listen({ipv4::any, port_to_use});
+    server.set_option(udp::receive_packet_info, true);
+    ASSERT_TRUE(server.option(udp::receive_packet_info));
+    client.listen({ipv4::loopback, 0});
+
+    // Whole 127.0.0.0/8 is assigned to loopback interface.
+    const address other_local(127, 0, 0, 2);
+    client.write(std::vector<uint8_t>{1, 2, 3}, {other_local, port_to_use});
+
+    std::vector<uint8_t> buffer;
+    endpoint source = endpoint::invalid;
+    udp::packet_info destination;
+    server.read(16, buffer, source, destination);
+    ASSERT_EQ(buffer, (std::vector<uint8_t>{1, 2, 3}));
+    ASSERT_EQ(source, client.implementation().local_endpoint());
+    ASSERT_EQ(destination.local, other_local);
+    ASSERT_NE(destination.interface_index, 0u);
+
+    // Reply must come from address request was sent to, not from one
+    // chosen by routing (127.0.0.1).
+    server.write(std::vector<uint8_t>{4, 5}, source, destination);
+    endpoint reply_source = endpoint::invalid;
+    client.read(16, buffer, &reply_source);
+    ASSERT_EQ(buffer, (std::vector<uint8_t>{4, 5}));
+    ASSERT_EQ(reply_source, endpoint(other_local, port_to_use));
+}
+
+TEST(UDPSocket, ReadInfo) {
+    udp::socket receiver(ip::v4), sender(ip::v4);
+    receiver.listen({ipv4::loopback, port_to_use});
+    receiver.set_option(udp::receive_timestamp, true);
+    receiver.set_option(udp::receive_drop_count, true);
+    // Unused here, but must not push out messages we need.
+    receiver.set_option(udp::receive_packet_info, true);
+    ASSERT_TRUE(receiver.option(udp::receive_timestamp));
+    ASSERT_TRUE(receiver.option(udp::receive_drop_count));
+
+    std::vector<uint8_t> payload(1000, 0xAB), buffer(2000);
+    auto before = std::chrono::system_clock::now();
+    sender.write(payload, {ipv4::loopback, port_to_use});
+    udp::datagram_info info = receiver.read({buffer.data(), buffer.size()});
+    auto after = std::chrono::system_clock::now();
+    ASSERT_EQ(info.size, payload.size());
+    ASSERT_FALSE(info.truncated);
+    ASSERT_EQ(info.source, endpoint(ipv4::loopback, sender.implementation().local_endpoint().port));
+    ASSERT_GE(info.timestamp, before);
+    ASSERT_LE(info.timestamp, after);
+    ASSERT_EQ(info.drops, 0u);
+
+    // Overflow receive buffer, datagrams that didn't fit are dropped.
+    const uint32_t sent = 1000;
+    for (uint32_t i = 0; i < sent; ++i) sender.write(payload, {ipv4::loopback, port_to_use});
+    receiver.set_option(non_blocking, true);
+    uint32_t queued = 0;
+    std::error_code ec;
+    while (receiver.read({buffer.data(), buffer.size()}, ec), !ec) ++queued;
+    ASSERT_LT(queued, sent);
+
+    receiver.set_option(non_blocking, false);
+    sender.write(payload, {ipv4::loopback, port_to_use});
+    info = receiver.read({buffer.data(), buffer.size()});
+    ASSERT_EQ(info.drops, sent - queued);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2018 Max Mazurov (fox.cpp) <fox.cpp [at] disroot [dot] org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include "../gtest.hpp"
+#include <libwire/udp.hpp>
+#include <libwire/options.hpp>
+#ifdef __linux__
+#    include <sched.h>
+#endif
+
+using namespace libwire;
+
+TEST(UDPSocketGroup, SharedEndpoint) {
+    udp::socket_group group({ipv4::loopback, 0}, 4);
+    ASSERT_EQ(group.size(), 4);
+    endpoint target = group.local_endpoint();
+    ASSERT_NE(target.port, 0);
+    for (const udp::socket& s : group) {
+        ASSERT_EQ(s.implementation().local_endpoint(), target);
+    }
+
+    // Socket without SO_REUSEPORT can't join the group.
+    std::error_code ec;
+    udp::socket intruder(ip::v4);
+    intruder.listen(target, ec);
+    ASSERT_EQ(ec, error::already_in_use);
+}
+
+TEST(UDPSocketGroup, Empty) {
+    udp::socket_group group;
+    ASSERT_EQ(group.local_endpoint(), endpoint::invalid);
+
+    std::error_code ec = std::make_error_code(std::errc::timed_out);
+    group.listen({ipv4::loopback, 0}, 0, ec);
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(group.size(), 0);
+    ASSERT_EQ(group.local_endpoint(), endpoint::invalid);
+}
+
+namespace {
+    /**
+     * Send one datagram from each of count distinct sockets to target,
+     * return count of datagrams received by each socket of group.
+     */
+    std::vector<size_t> distribute(udp::socket_group& group, size_t count) {
+        std::vector<udp::socket> clients;
+        for (size_t i = 0; i < count; ++i) {
+            clients.emplace_back(ip::v4).write(std::vector<uint8_t>{1, 2, 3}, group.local_endpoint());
+        }
+
+        std::vector<size_t> received;
+        std::vector<uint8_t> buffer(16);
+        for (udp::socket& s : group) {
+            s.set_option(non_blocking, true);
+            size_t received_here = 0;
+            std::error_code ec;
+            while (s.read({buffer.data(), buffer.size()}, ec), !ec) ++received_here;
+            received.push_back(received_here);
+        }
+        return received;
+    }
+} // namespace
+
+TEST(UDPSocketGroup, DatagramsDistributed) {
+    udp::socket_group group({ipv4::loopback, 0}, 4);
+
+    std::vector<size_t> received = distribute(group, 32);
+    ASSERT_EQ(std::accumulate(received.begin(), received.end(), size_t(0)), 32);
+    ASSERT_GT(std::count_if(received.begin(), received.end(), [](size_t n) { return n != 0; }), 1);
+}
+
+#ifdef __linux__
+TEST(UDPSocketGroup, SteerByCpu) {
+    udp::socket_group group({ipv4::loopback, 0}, 4);
+    std::error_code ec = std::make_error_code(std::errc::timed_out);
+    group.steer_by_cpu(ec);
+    ASSERT_FALSE(ec);
+
+    // Loopback datagrams are received on CPU of sender, so pin it.
+    cpu_set_t old_affinity, affinity;
+    sched_getaffinity(0, sizeof(old_affinity), &old_affinity);
+    int cpu = sched_getcpu();
+    CPU_ZERO(&affinity);
+    CPU_SET(cpu, &affinity);
+    sched_setaffinity(0, sizeof(affinity), &affinity);
+
+    std::vector<size_t> received = distribute(group, 32);
+    sched_setaffinity(0, sizeof(old_affinity), &old_affinity);
+
+    ASSERT_EQ(received[size_t(cpu) % group.size()], 32);
+
+    // Program is applied to group as whole, empty group has none.
+    udp::socket_group empty;
+    empty.steer_by_cpu(ec);
+    ASSERT_EQ(ec, error::invalid_argument);
+}
+#endif